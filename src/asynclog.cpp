@@ -0,0 +1,157 @@
+// Authors:	Sven Wiese
+//-----------------------------------------------------
+
+#include <cstring>
+#include <algorithm>
+
+#include "asynclog.hpp"
+#include "utils.hpp"
+
+/* pause of the writer when all rings are empty */
+#define LOGIDLEMSEC  5
+
+void
+formatlogrecord (char            *buf,
+                 size_t          len,
+                 const logrecord *rec)
+{
+    const char *f = rec->fmt;
+    size_t pos = 0;
+    int k = 0;
+
+    if ( len == 0 ) return;
+    while ( *f != '\0' && pos + 1 < len ) {
+        if ( *f != '%' ) {
+            buf[pos++] = *f++;
+            continue;
+        }
+        if ( f[1] == '%' ) {
+            buf[pos++] = '%';
+            f += 2;
+            continue;
+        }
+        /* one conversion: flags, width and precision are kept, the
+         * length modifiers are replaced by the type of the argument */
+        char spec[32];
+        size_t n = 0;
+        spec[n++] = *f++;
+        while ( *f != '\0' && strchr ("-+ #0123456789.", *f) != NULL && n < sizeof (spec) - 4 ) spec[n++] = *f++;
+        while ( *f != '\0' && strchr ("hlLqjzt", *f) != NULL ) f++;
+        char conv = *f;
+        if ( conv == '\0' ) break;
+        f++;
+        int w = 0;
+        if ( k >= rec->nargs ) {
+            /* more conversions than arguments: copied as they are */
+            spec[n++] = conv;
+            spec[n] = '\0';
+            w = snprintf (buf + pos, len - pos, "%s", spec);
+        } else if ( strchr ("di", conv) != NULL ) {
+            spec[n++] = 'l';
+            spec[n++] = 'l';
+            spec[n++] = conv;
+            spec[n] = '\0';
+            w = snprintf (buf + pos, len - pos, spec, rec->arg[k++].i);
+        } else if ( strchr ("ouxX", conv) != NULL ) {
+            spec[n++] = 'l';
+            spec[n++] = 'l';
+            spec[n++] = conv;
+            spec[n] = '\0';
+            w = snprintf (buf + pos, len - pos, spec, (unsigned long long) rec->arg[k++].i);
+        } else if ( conv == 'c' ) {
+            spec[n++] = conv;
+            spec[n] = '\0';
+            w = snprintf (buf + pos, len - pos, spec, (int) rec->arg[k++].i);
+        } else if ( conv == 's' ) {
+            const char *s = rec->arg[k++].s;
+            spec[n++] = conv;
+            spec[n] = '\0';
+            w = snprintf (buf + pos, len - pos, spec, s != NULL ? s : "(null)");
+        } else {
+            spec[n++] = conv;
+            spec[n] = '\0';
+            w = snprintf (buf + pos, len - pos, spec, rec->arg[k++].d);
+        }
+        if ( w < 0 ) break;
+        pos = XMIN (pos + (size_t) w, len - 1);
+    }
+    buf[pos] = '\0';
+}/*END formatlogrecord*/
+
+static bool
+earlier (const logrecord &a,
+         const logrecord &b)
+{
+    return a.ticks < b.ticks;
+}/*END earlier*/
+
+/* Moves the records of all rings to the screen and file until the log
+ * is stopped and the rings are empty. */
+static void
+logwriter (asynclog *log)
+{
+    std::vector<logrecord> batch;
+    char buf[1024];
+
+    for(;;){
+        bool stopping = log->stop.load (std::memory_order_acquire);
+        batch.clear ();
+        for(int r=0;r<log->nrings;r++){
+            logring *ring = &log->rings[r];
+            unsigned long h = ring->head.load (std::memory_order_acquire);
+            unsigned long t = ring->tail.load (std::memory_order_relaxed);
+            for(;t!=h;t++) batch.push_back (ring->rec[t & ring->mask]);
+            ring->tail.store (h, std::memory_order_release);
+        }
+        if ( batch.empty () ) {
+            if ( stopping ) break;
+            std::this_thread::sleep_for (std::chrono::milliseconds (LOGIDLEMSEC));
+            continue;
+        }
+        std::stable_sort (batch.begin (), batch.end (), earlier);
+        for(size_t k=0;k<batch.size();k++){
+            formatlogrecord (buf, sizeof (buf), &batch[k]);
+            if ( batch[k].dest & LOG_SCREEN ) fputs (buf, stdout);
+            if ( (batch[k].dest & LOG_FILE) && log->fout != NULL ) fputs (buf, log->fout);
+        }
+        log->written += (long) batch.size ();
+        fflush (stdout);
+    }
+}/*END logwriter*/
+
+int
+startasynclog (asynclog *log,
+               int      nrings,
+               int      capacity,
+               FILE     *fout)
+{
+    unsigned long size = 1;
+
+    if ( nrings < 1 || capacity < 1 ) return ERR_BADARGUMENT;
+    while ( size < (unsigned long) capacity ) size <<= 1;
+    log->rings.reset (new logring[nrings]);
+    log->nrings = nrings;
+    for(int r=0;r<nrings;r++){
+        log->rings[r].rec.resize (size);
+        log->rings[r].mask = size - 1;
+    }
+    log->fout = fout;
+    log->stop = false;
+    log->written = 0;
+    log->dropped = 0;
+    log->writer = std::thread (logwriter, log);
+    log->running = true;
+    return 0;
+}/*END startasynclog*/
+
+void
+stopasynclog (asynclog *log)
+{
+    if ( !log->running ) return;
+    log->stop.store (true, std::memory_order_release);
+    log->writer.join ();
+    log->running = false;
+    for(int r=0;r<log->nrings;r++) log->dropped += log->rings[r].dropped.load ();
+    fflush (stdout);
+    if ( log->fout != NULL ) fflush (log->fout);
+}/*END stopasynclog*/
@@ -0,0 +1,143 @@
+// Authors:	Sven Wiese
+//-----------------------------------------------------
+#ifndef asynclog_H
+#define asynclog_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/* destinations of a log record */
+#define LOG_SCREEN  1
+#define LOG_FILE    2
+
+#define LOGMAXARGS  8
+
+union logarg {
+   long long i;
+   double d;
+   const char *s;
+};
+
+/* One message: a printf format, which must stay valid until the log is
+ * stopped (a string literal), and its arguments. Strings are stored as
+ * pointers and must live as long as the format. */
+struct logrecord {
+   long long ticks;   /* steady_clock time of the call, orders the threads */
+   const char *fmt;
+   int dest;
+   int nargs;
+   logarg arg[LOGMAXARGS];
+};
+
+/* Records of one thread, from that thread to the writer. The thread
+ * only advances head, the writer only tail; a full ring drops the
+ * record instead of waiting. */
+struct logring {
+
+   logring() :	mask(0),
+		head(0),
+		tail(0),
+		dropped(0){}
+
+   std::vector<logrecord> rec;
+   unsigned long mask;
+   std::atomic<unsigned long> head;
+   std::atomic<unsigned long> tail;
+   std::atomic<long> dropped;
+   char pad[64];      /* keep the rings of different threads apart */
+};
+
+/* Log with one ring per thread and a background writer that formats the
+ * records in time order and writes them to stdout and fout. */
+struct asynclog {
+
+   asynclog() :	nrings(0),
+		fout(NULL),
+		stop(false),
+		running(false),
+		written(0),
+		dropped(0){}
+
+   std::unique_ptr<logring[]> rings;
+   int nrings;
+   FILE *fout;
+   std::thread writer;
+   std::atomic<bool> stop;
+   bool running;
+   long written;
+   long dropped;
+};
+
+/* Allocates nrings rings of at least capacity records each and starts
+ * the writer. Records for LOG_FILE go to fout. */
+int
+startasynclog (asynclog *log,
+               int      nrings,
+               int      capacity,
+               FILE     *fout);
+
+/* Stops the writer after it has written all records and flushes
+ * stdout and fout; does nothing if the log is not running. */
+void
+stopasynclog (asynclog *log);
+
+/* Formats rec like printf into buf. */
+void
+formatlogrecord (char            *buf,
+                 size_t          len,
+                 const logrecord *rec);
+
+inline void setlogarg (logarg *a, int v)                { a->i = v; }
+inline void setlogarg (logarg *a, unsigned int v)       { a->i = v; }
+inline void setlogarg (logarg *a, long v)               { a->i = v; }
+inline void setlogarg (logarg *a, unsigned long v)      { a->i = (long long) v; }
+inline void setlogarg (logarg *a, long long v)          { a->i = v; }
+inline void setlogarg (logarg *a, char v)               { a->i = v; }
+inline void setlogarg (logarg *a, bool v)               { a->i = v; }
+inline void setlogarg (logarg *a, double v)             { a->d = v; }
+inline void setlogarg (logarg *a, const char *v)        { a->s = v; }
+
+inline int
+setlogargs (logarg *)
+{
+    return 0;
+}/*END setlogargs*/
+
+template<typename T, typename... Args> inline int
+setlogargs (logarg   *a,
+            T        v,
+            Args...  rest)
+{
+    setlogarg (a, v);
+    return 1 + setlogargs (a+1, rest...);
+}/*END setlogargs*/
+
+/* Queues the message fmt with its arguments on ring for the screen
+ * and/or the file (dest), without blocking. Called only by the thread
+ * that owns the ring. */
+template<typename... Args> inline void
+logmsg (logring    *ring,
+        int        dest,
+        const char *fmt,
+        Args...    args)
+{
+    static_assert (sizeof... (Args) <= LOGMAXARGS, "too many log arguments");
+
+    unsigned long h = ring->head.load (std::memory_order_relaxed);
+    if ( h - ring->tail.load (std::memory_order_acquire) > ring->mask ) {
+        ring->dropped.store (ring->dropped.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+    logrecord *rec = &ring->rec[h & ring->mask];
+    rec->ticks = std::chrono::steady_clock::now ().time_since_epoch ().count ();
+    rec->fmt = fmt;
+    rec->dest = dest;
+    rec->nargs = setlogargs (rec->arg, args...);
+    ring->head.store (h+1, std::memory_order_release);
+}/*END logmsg*/
+
+#endif
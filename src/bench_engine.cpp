@@ -0,0 +1,156 @@
+// Authors:	Sven Wiese
+//-----------------------------------------------------
+// Microbenchmark of the hole engine on synthetic data, does not need CPLEX.
+//
+//   bench_engine [nvars] [holes per variable] [repetitions]
+//
+// Without nvars, the sizes 1000, 10000 and 100000 are run in turn.
+// Reports the time of an in-hole check of a single value (findhole),
+// of a whole incumbent (findviolation, per hole) and of a branching
+// decision (selectholevars, widesplit and snapholebounds).
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <vector>
+
+#include "holeindex.hpp"
+#include "pseudocost.hpp"
+#include "utils.hpp"
+
+/* nvars variables in [0,20*nholes] with nholes holes each, one column
+ * per variable */
+static int
+buildsynthetic (int       nvars,
+                int       nholes,
+                holeindex *idx)
+{
+    std::vector<double> lbvar(nvars, 0.0);
+    std::vector<double> ubvar(nvars, 20.0*nholes);
+    std::vector<int> nholesvar(nvars, nholes);
+    std::vector<double> lbstore((size_t)nvars*nholes);
+    std::vector<double> ubstore((size_t)nvars*nholes);
+    std::vector<double*> lbholes(nvars);
+    std::vector<double*> ubholes(nvars);
+    std::vector<char*> names(nvars);
+    std::vector<char> namestore((size_t)nvars*12);
+    std::vector<int> col(nvars);
+
+    srand (1);
+    for(int i=0;i<nvars;i++){
+        lbholes[i] = &lbstore[(size_t)i*nholes];
+        ubholes[i] = &ubstore[(size_t)i*nholes];
+        for(int k=0;k<nholes;k++){
+            int l = 20*k + 1 + rand()%9;
+            lbholes[i][k] = l;
+            ubholes[i][k] = l + rand()%9;
+        }
+        names[i] = &namestore[(size_t)i*12];
+        snprintf (names[i], 12, "x%d", i);
+        col[i] = i;
+    }
+
+    int status = buildholeindex (nvars, &lbvar[0], &ubvar[0], &nholesvar[0], &names[0],
+                                 &lbholes[0], &ubholes[0], idx);
+    if ( status ) return status;
+    return setholecols (idx, nvars, &col[0]);
+}
+
+static int
+runbench (int nvars,
+          int nholes,
+          int nrep)
+{
+    typedef std::chrono::steady_clock clock;
+
+    holeindex idx;
+    pseudocost pc;
+    int status = buildsynthetic (nvars, nholes, &idx);
+    if ( status ) return status;
+    initpseudocost (&pc, nvars);
+
+    double ubvar = 20.0*nholes;
+    std::vector<double> lb(nvars, 0.0);
+    std::vector<double> ub(nvars, ubvar);
+    std::vector<double> probe(1 << 16);
+    std::vector<double> x(nvars);
+
+    srand (2);
+    for(size_t k=0;k<probe.size();k++) probe[k] = ubvar*rand()/RAND_MAX;
+    for(int i=0;i<nvars;i++){
+        /* a hole-free value: 0 or the upper bound of a hole plus one */
+        int k = rand()%(nholes+1);
+        x[i] = k == 0 ? 0 : idx.ub[idx.beg[i]+k-1]+1;
+        updatepseudocost (&pc, i, rand()%2 == 0, 1.0, rand()%100);
+    }
+
+    /* single value lookups */
+    long nlookup = 0;
+    long hits = 0;
+    clock::time_point t0 = clock::now();
+    for(int r=0;r<nrep;r++){
+        for(int i=0;i<nvars;i++){
+            hits += findhole (&idx, i, probe[(size_t)(r*nvars+i) & (probe.size()-1)], EPSVIOL) >= 0;
+            nlookup++;
+        }
+    }
+    clock::time_point t1 = clock::now();
+
+    /* full incumbent checks of a hole-free vector, the worst case */
+    int var = -1;
+    long nviol = 0;
+    for(int r=0;r<nrep;r++) nviol += findviolation (&idx, &x[0], EPSVIOL, &var) >= 0;
+    clock::time_point t2 = clock::now();
+
+    /* branching decisions: one variable moved into a hole each time */
+    int ndecide = XMAX (nrep*10, 100);
+    long nbranch = 0;
+    int sel[4], selh[4];
+    double selscore[4];
+    clock::time_point t3 = clock::now();
+    for(int r=0;r<ndecide;r++){
+        int i = (int)(((long)r*7919) % nvars);
+        double old = x[i];
+        int h = idx.beg[i] + r%nholes;
+        x[i] = 0.5*(idx.lb[h]+idx.ub[h]) + 0.25;
+        int n = selectholevars (&idx, &pc, &x[0], &lb[0], &ub[0], 4, sel, selh, selscore);
+        double pi0, pi1;
+        if ( n > 0 && widesplit (&idx, sel[0], x[idx.col[sel[0]]], true, &pi0, &pi1) ) {
+            double lo = lb[sel[0]], up = pi0;
+            nbranch += snapholebounds (&idx, sel[0], &lo, &up);
+            lo = pi1;
+            up = ub[sel[0]];
+            nbranch += snapholebounds (&idx, sel[0], &lo, &up);
+        }
+        x[i] = old;
+    }
+    clock::time_point t4 = clock::now();
+
+    double tlookup = std::chrono::duration<double,std::nano>(t1-t0).count();
+    double tviol = std::chrono::duration<double,std::nano>(t2-t1).count();
+    double tdecide = std::chrono::duration<double,std::nano>(t4-t3).count();
+
+    printf ("%7d variables, %3d holes each: findhole %6.1lf ns/check (%ld hits), "
+            "findviolation %6.2lf ns/hole (%ld violated), branch decision %10.1lf ns (%ld children)\n",
+            nvars, nholes, tlookup/nlookup, hits, tviol/((double)nrep*idx.nholes), nviol,
+            tdecide/ndecide, nbranch);
+
+    freeholeindex (&idx);
+    return 0;
+}
+
+int main(int argc, const char *argv[])
+{
+    int status = 0;
+    int nholes = (argc > 2) ? atoi (argv[2]) : 16;
+    int nrep = (argc > 3) ? atoi (argv[3]) : 20;
+
+    if ( nholes <= 0 || nrep <= 0 ) return ERR_BADARGUMENT;
+    if ( argc > 1 ) {
+        status = runbench (atoi (argv[1]), nholes, nrep);
+    } else {
+        for(int nvars=1000;nvars<=100000 && status == 0;nvars*=10)
+            status = runbench (nvars, nholes, nrep);
+    }
+    return status;
+}
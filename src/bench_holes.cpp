@@ -0,0 +1,154 @@
+// Authors:	Sven Wiese
+//-----------------------------------------------------
+// Microbenchmark of the hole file loaders (text and binary), does not need CPLEX.
+//
+//   bench_holes [holefile] [repetitions]
+//
+// Without a hole file, a synthetic one is written to a temporary file.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+
+#include <unistd.h>
+
+#include "holes.hpp"
+#include "holeindex.hpp"
+#include "utils.hpp"
+
+static int
+writesynthetic (const char *filename,
+                int        nvars,
+                int        nholes)
+{
+    FILE *fout = fopen (filename, "w");
+    if ( fout == NULL ) return ERR_OPENFILE;
+
+    srand (1);
+    fprintf (fout, "%d\n", nvars);
+    for(int i=0;i<nvars;i++){
+        int ub = 20*nholes;
+        fprintf (fout, "x%d 0 %d %d", i, ub, nholes);
+        for(int j=0;j<nholes;j++){
+            int l = 20*j + 1 + rand()%9;
+            fprintf (fout, " %d %d", l, l + rand()%9);
+        }
+        fprintf (fout, "\n");
+    }
+    fclose (fout);
+    return 0;
+}
+
+static bool
+sameindex (const holeindex *a,
+           const holeindex *b)
+{
+    if ( a->nvars != b->nvars || a->nholes != b->nholes ) return false;
+    for(int i=0;i<a->nvars;i++){
+        if ( a->beg[i+1] != b->beg[i+1] ||
+             a->lbvar[i] != b->lbvar[i] ||
+             a->ubvar[i] != b->ubvar[i] ||
+             strcmp (holevarname (a,i), holevarname (b,i)) ) return false;
+    }
+    for(int h=0;h<a->nholes;h++){
+        if ( a->lb[h] != b->lb[h] || a->ub[h] != b->ub[h] ) return false;
+    }
+    return true;
+}
+
+int main(int argc, const char *argv[])
+{
+    typedef std::chrono::steady_clock clock;
+
+    int status = 0;
+    char tmpname[] = "/tmp/bench_holesXXXXXX";
+    char binname[] = "/tmp/bench_holesXXXXXX";
+    const char *filename = NULL;
+    int nrep = (argc > 2) ? atoi (argv[2]) : 5;
+    double treadholes = 0;
+    double tmmap = 0;
+    double tbin = 0;
+
+    if ( argc > 1 ) {
+        filename = argv[1];
+    } else {
+        int fd = mkstemp (tmpname);
+        if ( fd < 0 ) return ERR_OPENFILE;
+        close (fd);
+        filename = tmpname;
+        status = writesynthetic (filename, 200000, 16);
+        if ( status ) goto TERMINATE;
+    }
+    {
+        int fd = mkstemp (binname);
+        if ( fd < 0 ) {
+            status = ERR_OPENFILE;
+            goto TERMINATE;
+        }
+        close (fd);
+    }
+
+    for(int r=0;r<nrep;r++){
+        int nvarswithholes=0;
+        double *lbvarswithholes=NULL;
+        double *ubvarswithholes=NULL;
+        int *nholesvarswithholes=NULL;
+        char **namevarswithholes=NULL;
+        double **lbholes=NULL;
+        double **ubholes=NULL;
+        holeindex a, b, c;
+
+        clock::time_point t0 = clock::now();
+        status = readholes (filename,&nvarswithholes,&lbvarswithholes,
+                            &ubvarswithholes,&nholesvarswithholes,
+                            &namevarswithholes,&lbholes,&ubholes);
+        if ( status == 0 )
+            status = buildholeindex (nvarswithholes,lbvarswithholes,ubvarswithholes,
+                                     nholesvarswithholes,namevarswithholes,
+                                     lbholes,ubholes,&a);
+        clock::time_point t1 = clock::now();
+        FREEN (&lbvarswithholes);
+        FREEN (&ubvarswithholes);
+        FREEN_mat (&lbholes,nvarswithholes);
+        FREEN_mat (&ubholes,nvarswithholes);
+        FREEN (&nholesvarswithholes);
+        FREEN_mat (&namevarswithholes,nvarswithholes);
+        if ( status ) goto TERMINATE;
+
+        clock::time_point t2 = clock::now();
+        status = readholes_mmap (filename, &b);
+        clock::time_point t3 = clock::now();
+        if ( status ) goto TERMINATE;
+
+        if ( r == 0 ) status = writeholes_bin (binname, &b, NULL);
+        clock::time_point t4 = clock::now();
+        if ( status == 0 ) status = readholes_bin (binname, &c);
+        clock::time_point t5 = clock::now();
+
+        if ( status == 0 && (!sameindex (&a, &b) || !sameindex (&a, &c)) ) {
+            printf ("ERROR: loaders disagree on %s\n", filename);
+            status = ERR_BADFILEFORMAT;
+        }
+        if ( r == 0 ) printf ("%s: %d variables, %d holes\n", filename, b.nvars, b.nholes);
+        freeholeindex (&a);
+        freeholeindex (&b);
+        freeholeindex (&c);
+        if ( status ) goto TERMINATE;
+
+        treadholes += std::chrono::duration<double>(t1-t0).count();
+        tmmap += std::chrono::duration<double>(t3-t2).count();
+        tbin += std::chrono::duration<double>(t5-t4).count();
+    }
+
+    printf ("readholes+buildholeindex: %.4lf sec\n", treadholes/nrep);
+    printf ("readholes_mmap:           %.4lf sec (%.1fx)\n", tmmap/nrep, treadholes/tmmap);
+    printf ("readholes_bin:            %.4lf sec (%.1fx)\n", tbin/nrep, treadholes/tbin);
+
+TERMINATE:
+
+    if ( filename == tmpname ) unlink (tmpname);
+    unlink (binname);
+
+    return status;
+}
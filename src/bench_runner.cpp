@@ -0,0 +1,545 @@
+// Authors:	Sven Wiese
+//-----------------------------------------------------
+// Batch benchmark driver for branch_and_hole, does not need CPLEX itself.
+//
+//   bench_runner [options] instancedir
+//   bench_runner -compare old.csv new.csv [-tol 0.10] [-mintime 1.0]
+//
+// Runs the solver on every .mps/.lp file of instancedir for every
+// combination of configurations, time limits and seeds, with up to
+// -jobs runs at a time, and writes one row per run to <out>.csv and
+// <out>.json. The output and .bblog of every run go to <out>_logs/.
+//
+//   -bin path       solver binary (default ./branch_and_hole)
+//   -axis "A|B|C"   one axis of alternative option strings; the
+//                   configurations are all combinations of the axes,
+//                   e.g. -axis "-inc|-inc -br" -axis "|-c" -axis "-n 0|-n 5"
+//   -times t1,t2    values of -bab_time
+//   -seeds s1,s2    values of -seed
+//   -jobs k         number of parallel runs (default 1)
+//   -out name       result file prefix (default bench)
+//
+// The comparison matches the runs of two result files by instance,
+// configuration, time limit and seed and flags lost optimality, failed
+// runs, larger gaps, different optimal values, and runs that are
+// slower by more than -tol (relative) and -mintime (seconds). It
+// exits with 1 if there is a regression.
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "utils.hpp"
+
+struct benchrun {
+
+   benchrun() :	seed(-1),
+			exitcode(-1),
+			wall(0),
+			time(0),
+			nodes(-1),
+			bound(NAN),
+			sol(NAN),
+			gap(NAN),
+			cuts(0),
+			increjected(0),
+			inccalled(0),
+			brstr(0),
+			brchange(0),
+			maxrss(0){}
+
+   std::string instance;
+   std::string config;
+   std::string timelimit;
+   int seed;
+   std::string log;
+   int exitcode;
+   std::string status;
+   double wall;       /* seconds, measured by the driver */
+   double time;       /* solve time reported by the solver */
+   long nodes;
+   double bound;
+   double sol;
+   double gap;
+   int cuts;
+   int increjected;
+   int inccalled;
+   int brstr;
+   int brchange;
+   long maxrss;       /* peak resident set size in KB */
+};
+
+static std::vector<std::string>
+splitstring (const std::string &s,
+             char              sep)
+{
+    std::vector<std::string> parts;
+    std::string part;
+    std::istringstream in(s);
+    while ( std::getline (in, part, sep) ) parts.push_back (part);
+    if ( !s.empty () && s[s.size()-1] == sep ) parts.push_back ("");
+    if ( s.empty () ) parts.push_back ("");
+    return parts;
+}/*END splitstring*/
+
+static std::string
+trim (const std::string &s)
+{
+    size_t b = s.find_first_not_of (" \t");
+    if ( b == std::string::npos ) return "";
+    size_t e = s.find_last_not_of (" \t");
+    return s.substr (b, e-b+1);
+}/*END trim*/
+
+static std::string
+basename_noext (const std::string &path)
+{
+    size_t slash = path.find_last_of ('/');
+    std::string name = slash == std::string::npos ? path : path.substr (slash+1);
+    size_t dot = name.find_last_of ('.');
+    return dot == std::string::npos ? name : name.substr (0, dot);
+}/*END basename_noext*/
+
+/* .mps and .lp files of dir, sorted */
+static int
+listinstances (const char               *dir,
+               std::vector<std::string> &files)
+{
+    DIR *d = opendir (dir);
+    if ( d == NULL ) return ERR_OPENFILE;
+    struct dirent *e;
+    while ( (e = readdir (d)) != NULL ) {
+        std::string name = e->d_name;
+        if ( (name.size () > 4 && name.compare (name.size()-4, 4, ".mps") == 0) ||
+             (name.size () > 3 && name.compare (name.size()-3, 3, ".lp") == 0) ) {
+            files.push_back (std::string (dir) + "/" + name);
+        }
+    }
+    closedir (d);
+    std::sort (files.begin (), files.end ());
+    return 0;
+}/*END listinstances*/
+
+/* reads the BRANCH-AND-HOLE line from the output of a run */
+static void
+parseresult (benchrun *run)
+{
+    FILE *fin = fopen (run->log.c_str (), "r");
+    if ( fin == NULL ) return;
+    char line[4096];
+    while ( fgets (line, sizeof (line), fin) != NULL ) {
+        if ( strncmp (line, "BRANCH-AND-HOLE:", 16) ) continue;
+        char status[64];
+        if ( sscanf (line, "BRANCH-AND-HOLE: nodes %ld bound %lf sol %lf %63s cuts %d incs %d/%d branch %d/%d time %lf",
+                     &run->nodes, &run->bound, &run->sol, status, &run->cuts, &run->increjected, &run->inccalled,
+                     &run->brstr, &run->brchange, &run->time) >= 4 ) {
+            run->status = status;
+        }
+    }
+    fclose (fin);
+    if ( run->status.empty () ) {
+        run->status = "FAILED";
+    } else if ( fabs (run->sol) < 1e+74 ) {
+        run->gap = fabs (run->sol - run->bound)/XMAX (1e-10, fabs (run->sol));
+    }
+}/*END parseresult*/
+
+static pid_t
+startrun (const std::string &bin,
+          benchrun          *run,
+          const std::string &logdir,
+          int               k)
+{
+    std::ostringstream name;
+    name << logdir << "/" << basename_noext (run->instance) << "_" << k;
+    run->log = name.str () + ".out";
+
+    std::vector<std::string> args;
+    args.push_back (bin);
+    std::istringstream cfg(run->config);
+    std::string tok;
+    while ( cfg >> tok ) args.push_back (tok);
+    if ( !run->timelimit.empty () ) {
+        args.push_back ("-bab_time");
+        args.push_back (run->timelimit);
+    }
+    if ( run->seed >= 0 ) {
+        std::ostringstream s;
+        s << run->seed;
+        args.push_back ("-seed");
+        args.push_back (s.str ());
+    }
+    args.push_back ("-logfile");
+    args.push_back (name.str () + ".bblog");
+    args.push_back (run->instance);
+
+    pid_t pid = fork ();
+    if ( pid != 0 ) return pid;
+
+    /* child */
+    int fd = open (run->log.c_str (), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if ( fd >= 0 ) {
+        dup2 (fd, STDOUT_FILENO);
+        dup2 (fd, STDERR_FILENO);
+        close (fd);
+    }
+    std::vector<char*> argv;
+    for(size_t a=0;a<args.size();a++) argv.push_back (const_cast<char*>(args[a].c_str ()));
+    argv.push_back (NULL);
+    execv (bin.c_str (), &argv[0]);
+    fprintf (stderr, "cannot execute %s\n", bin.c_str ());
+    _exit (127);
+}/*END startrun*/
+
+static std::string
+csvfield (const std::string &s)
+{
+    if ( s.find_first_of (",\"") == std::string::npos ) return s;
+    std::string q = "\"";
+    for(size_t k=0;k<s.size();k++){
+        if ( s[k] == '"' ) q += '"';
+        q += s[k];
+    }
+    return q + "\"";
+}/*END csvfield*/
+
+static std::string
+jsonstring (const std::string &s)
+{
+    std::string q = "\"";
+    for(size_t k=0;k<s.size();k++){
+        if ( s[k] == '"' || s[k] == '\\' ) q += '\\';
+        q += s[k];
+    }
+    return q + "\"";
+}/*END jsonstring*/
+
+static std::string
+jsonnumber (double v)
+{
+    if ( std::isnan (v) || std::isinf (v) ) return "null";
+    char buf[64];
+    snprintf (buf, sizeof (buf), "%.10g", v);
+    return buf;
+}/*END jsonnumber*/
+
+static const char *csvheader =
+    "instance,config,timelimit,seed,exitcode,status,wall,time,nodes,bound,sol,gap,"
+    "cuts,increjected,inccalled,brstr,brchange,maxrss_kb,log";
+
+static int
+writeresults (const std::string            &out,
+              const std::vector<benchrun>  &runs)
+{
+    FILE *csv = fopen ((out + ".csv").c_str (), "w");
+    FILE *json = fopen ((out + ".json").c_str (), "w");
+    if ( csv == NULL || json == NULL ) {
+        if ( csv != NULL ) fclose (csv);
+        if ( json != NULL ) fclose (json);
+        return ERR_OPENFILE;
+    }
+    fprintf (csv, "%s\n", csvheader);
+    fprintf (json, "[\n");
+    for(size_t k=0;k<runs.size();k++){
+        const benchrun &r = runs[k];
+        fprintf (csv, "%s,%s,%s,%d,%d,%s,%.3lf,%.3lf,%ld,%.10g,%.10g,%.6g,%d,%d,%d,%d,%d,%ld,%s\n",
+                 csvfield (r.instance).c_str (), csvfield (r.config).c_str (), r.timelimit.c_str (), r.seed,
+                 r.exitcode, r.status.c_str (), r.wall, r.time, r.nodes, r.bound, r.sol, r.gap,
+                 r.cuts, r.increjected, r.inccalled, r.brstr, r.brchange, r.maxrss, csvfield (r.log).c_str ());
+        fprintf (json, "  {\"instance\": %s, \"config\": %s, \"timelimit\": %s, \"seed\": %d, \"exitcode\": %d, "
+                 "\"status\": %s, \"wall\": %s, \"time\": %s, \"nodes\": %ld, \"bound\": %s, \"sol\": %s, \"gap\": %s, "
+                 "\"cuts\": %d, \"increjected\": %d, \"inccalled\": %d, \"brstr\": %d, \"brchange\": %d, "
+                 "\"maxrss_kb\": %ld, \"log\": %s}%s\n",
+                 jsonstring (r.instance).c_str (), jsonstring (r.config).c_str (),
+                 r.timelimit.empty () ? "null" : jsonnumber (atof (r.timelimit.c_str ())).c_str (), r.seed, r.exitcode,
+                 jsonstring (r.status).c_str (), jsonnumber (r.wall).c_str (), jsonnumber (r.time).c_str (), r.nodes,
+                 jsonnumber (r.bound).c_str (), jsonnumber (r.sol).c_str (), jsonnumber (r.gap).c_str (),
+                 r.cuts, r.increjected, r.inccalled, r.brstr, r.brchange, r.maxrss, jsonstring (r.log).c_str (),
+                 k+1 < runs.size () ? "," : "");
+    }
+    fprintf (json, "]\n");
+    fclose (csv);
+    fclose (json);
+    return 0;
+}/*END writeresults*/
+
+/* splits a line of a result file, honouring quoted fields */
+static std::vector<std::string>
+splitcsv (const std::string &line)
+{
+    std::vector<std::string> fields(1);
+    bool quoted = false;
+    for(size_t k=0;k<line.size();k++){
+        char c = line[k];
+        if ( quoted ) {
+            if ( c == '"' && k+1 < line.size () && line[k+1] == '"' ) fields.back () += line[++k];
+            else if ( c == '"' ) quoted = false;
+            else fields.back () += c;
+        } else if ( c == '"' ) {
+            quoted = true;
+        } else if ( c == ',' ) {
+            fields.push_back ("");
+        } else if ( c != '\n' && c != '\r' ) {
+            fields.back () += c;
+        }
+    }
+    return fields;
+}/*END splitcsv*/
+
+static int
+readresults (const char                        *filename,
+             std::map<std::string, benchrun>   &runs)
+{
+    FILE *fin = fopen (filename, "r");
+    if ( fin == NULL ) {
+        printf ("ERROR: cannot open %s\n", filename);
+        return ERR_OPENFILE;
+    }
+    char *line = NULL;
+    size_t cap = 0;
+    bool header = true;
+    while ( getline (&line, &cap, fin) >= 0 ) {
+        if ( header ) {
+            header = false;
+            continue;
+        }
+        std::vector<std::string> f = splitcsv (line);
+        if ( f.size () < 19 ) continue;
+        benchrun r;
+        r.instance = f[0];
+        r.config = f[1];
+        r.timelimit = f[2];
+        r.seed = atoi (f[3].c_str ());
+        r.exitcode = atoi (f[4].c_str ());
+        r.status = f[5];
+        r.wall = atof (f[6].c_str ());
+        r.time = atof (f[7].c_str ());
+        r.nodes = atol (f[8].c_str ());
+        r.bound = atof (f[9].c_str ());
+        r.sol = atof (f[10].c_str ());
+        r.gap = atof (f[11].c_str ());
+        r.maxrss = atol (f[17].c_str ());
+        runs[f[0] + "|" + f[1] + "|" + f[2] + "|" + f[3]] = r;
+    }
+    free (line);
+    fclose (fin);
+    return 0;
+}/*END readresults*/
+
+static int
+compareresults (const char *oldfile,
+                const char *newfile,
+                double     tol,
+                double     mintime)
+{
+    std::map<std::string, benchrun> oldruns, newruns;
+    int status = readresults (oldfile, oldruns);
+    if ( status == 0 ) status = readresults (newfile, newruns);
+    if ( status ) return status;
+
+    int nregress = 0;
+    int nimprove = 0;
+    int nmissing = 0;
+    double oldtime = 0;
+    double newtime = 0;
+    for(std::map<std::string, benchrun>::iterator it=oldruns.begin();it!=oldruns.end();++it){
+        std::map<std::string, benchrun>::iterator jt = newruns.find (it->first);
+        const benchrun &o = it->second;
+        if ( jt == newruns.end () ) {
+            printf ("MISSING     %s [%s]\n", o.instance.c_str (), o.config.c_str ());
+            nmissing++;
+            continue;
+        }
+        const benchrun &n = jt->second;
+        std::string run = n.instance + " [" + n.config + "]";
+        if ( !n.timelimit.empty () ) run += " time " + n.timelimit;
+        if ( n.seed >= 0 ) run += " seed " + std::to_string (n.seed);
+        oldtime += o.wall;
+        newtime += n.wall;
+
+        if ( o.status != "FAILED" && n.status == "FAILED" ) {
+            printf ("REGRESSION  %s: run failed (exit code %d)\n", run.c_str (), n.exitcode);
+            nregress++;
+        } else if ( o.status == "OPTIMAL" && n.status != "OPTIMAL" ) {
+            printf ("REGRESSION  %s: %s, was OPTIMAL\n", run.c_str (), n.status.c_str ());
+            nregress++;
+        } else if ( o.status == "OPTIMAL" && n.status == "OPTIMAL" &&
+                    fabs (o.sol - n.sol) > 1e-6*XMAX (1.0, fabs (o.sol)) ) {
+            printf ("REGRESSION  %s: optimal value %.10g, was %.10g\n", run.c_str (), n.sol, o.sol);
+            nregress++;
+        } else if ( n.status != "OPTIMAL" && !std::isnan (o.gap) && (std::isnan (n.gap) || n.gap > o.gap + 1e-6) ) {
+            printf ("REGRESSION  %s: gap %.4g%%, was %.4g%%\n", run.c_str (), 100*n.gap, 100*o.gap);
+            nregress++;
+        } else if ( n.wall > o.wall*(1+tol) && n.wall - o.wall > mintime ) {
+            printf ("SLOWER      %s: %.2lf sec, was %.2lf sec\n", run.c_str (), n.wall, o.wall);
+            nregress++;
+        } else if ( o.wall > n.wall*(1+tol) && o.wall - n.wall > mintime ) {
+            printf ("FASTER      %s: %.2lf sec, was %.2lf sec\n", run.c_str (), n.wall, o.wall);
+            nimprove++;
+        } else if ( o.status != "OPTIMAL" && n.status == "OPTIMAL" ) {
+            printf ("SOLVED      %s\n", run.c_str ());
+            nimprove++;
+        }
+    }
+    for(std::map<std::string, benchrun>::iterator it=newruns.begin();it!=newruns.end();++it){
+        if ( oldruns.find (it->first) == oldruns.end () ) printf ("NEW         %s [%s]\n", it->second.instance.c_str (), it->second.config.c_str ());
+    }
+    printf ("%d runs compared, %d regressions, %d improvements, %d missing, total time %.2lf -> %.2lf sec\n",
+            (int)(oldruns.size () - nmissing), nregress, nimprove, nmissing, oldtime, newtime);
+    return nregress > 0 ? 1 : 0;
+}/*END compareresults*/
+
+int main(int argc, const char *argv[])
+{
+    typedef std::chrono::steady_clock clock;
+
+    std::string bin = "./branch_and_hole";
+    std::string out = "bench";
+    std::vector< std::vector<std::string> > axes;
+    std::vector<std::string> times;
+    std::vector<int> seeds;
+    int jobs = 1;
+    double tol = 0.10;
+    double mintime = 1.0;
+    const char *instdir = NULL;
+    std::vector<const char*> compare;
+
+    for(int a=1;a<argc;a++){
+        std::string o = argv[a];
+        bool hasarg = a+1 < argc;
+        if ( o == "-compare" && a+2 < argc ) {
+            compare.push_back (argv[++a]);
+            compare.push_back (argv[++a]);
+        } else if ( o == "-bin" && hasarg ) {
+            bin = argv[++a];
+        } else if ( o == "-out" && hasarg ) {
+            out = argv[++a];
+        } else if ( o == "-axis" && hasarg ) {
+            std::vector<std::string> alt = splitstring (argv[++a], '|');
+            for(size_t k=0;k<alt.size();k++) alt[k] = trim (alt[k]);
+            axes.push_back (alt);
+        } else if ( o == "-times" && hasarg ) {
+            times = splitstring (argv[++a], ',');
+        } else if ( o == "-seeds" && hasarg ) {
+            std::vector<std::string> s = splitstring (argv[++a], ',');
+            for(size_t k=0;k<s.size();k++) seeds.push_back (atoi (s[k].c_str ()));
+        } else if ( o == "-jobs" && hasarg ) {
+            jobs = atoi (argv[++a]);
+            if ( jobs < 1 ) jobs = 1;
+        } else if ( o == "-tol" && hasarg ) {
+            tol = atof (argv[++a]);
+        } else if ( o == "-mintime" && hasarg ) {
+            mintime = atof (argv[++a]);
+        } else if ( o[0] != '-' && instdir == NULL ) {
+            instdir = argv[a];
+        } else {
+            printf ("usage: bench_runner [-bin path] [-axis \"A|B\"]... [-times t1,t2] [-seeds s1,s2] [-jobs k] [-out name] instancedir\n");
+            printf ("       bench_runner -compare old.csv new.csv [-tol 0.10] [-mintime 1.0]\n");
+            return ERR_BADARGUMENT;
+        }
+    }
+    if ( !compare.empty () ) return compareresults (compare[0], compare[1], tol, mintime);
+    if ( instdir == NULL ) {
+        printf ("ERROR: no instance directory\n");
+        return ERR_BADARGUMENT;
+    }
+
+    std::vector<std::string> instances;
+    int status = listinstances (instdir, instances);
+    if ( status || instances.empty () ) {
+        printf ("ERROR: no instances in %s\n", instdir);
+        return status ? status : ERR_BADARGUMENT;
+    }
+
+    /* all combinations of the axes */
+    std::vector<std::string> configs(1, "");
+    for(size_t x=0;x<axes.size();x++){
+        std::vector<std::string> next;
+        for(size_t c=0;c<configs.size();c++){
+            for(size_t k=0;k<axes[x].size();k++){
+                std::string cfg = configs[c];
+                if ( !cfg.empty () && !axes[x][k].empty () ) cfg += " ";
+                next.push_back (cfg + axes[x][k]);
+            }
+        }
+        configs.swap (next);
+    }
+    if ( times.empty () ) times.push_back ("");
+    if ( seeds.empty () ) seeds.push_back (-1);
+
+    std::vector<benchrun> runs;
+    for(size_t i=0;i<instances.size();i++){
+        for(size_t c=0;c<configs.size();c++){
+            for(size_t t=0;t<times.size();t++){
+                for(size_t s=0;s<seeds.size();s++){
+                    benchrun r;
+                    r.instance = instances[i];
+                    r.config = configs[c];
+                    r.timelimit = times[t];
+                    r.seed = seeds[s];
+                    runs.push_back (r);
+                }
+            }
+        }
+    }
+
+    std::string logdir = out + "_logs";
+    mkdir (logdir.c_str (), 0755);
+    printf ("%d instances, %d configurations, %d runs, %d at a time\n",
+            (int)instances.size (), (int)configs.size (), (int)runs.size (), jobs);
+
+    std::map<pid_t, size_t> running;
+    std::vector<clock::time_point> started(runs.size ());
+    size_t nextrun = 0;
+    size_t ndone = 0;
+    while ( ndone < runs.size () ) {
+        while ( nextrun < runs.size () && (int)running.size () < jobs ) {
+            started[nextrun] = clock::now ();
+            pid_t pid = startrun (bin, &runs[nextrun], logdir, (int)nextrun);
+            if ( pid < 0 ) {
+                printf ("ERROR: cannot start a run\n");
+                return ERR_BADARGUMENT;
+            }
+            running[pid] = nextrun++;
+        }
+        int wstatus = 0;
+        struct rusage usage;
+        pid_t pid = wait4 (-1, &wstatus, 0, &usage);
+        if ( pid < 0 ) break;
+        std::map<pid_t, size_t>::iterator it = running.find (pid);
+        if ( it == running.end () ) continue;
+        benchrun &r = runs[it->second];
+        r.wall = std::chrono::duration<double>(clock::now () - started[it->second]).count ();
+        r.exitcode = WIFEXITED (wstatus) ? WEXITSTATUS (wstatus) : 128 + WTERMSIG (wstatus);
+        r.maxrss = usage.ru_maxrss;
+        parseresult (&r);
+        running.erase (it);
+        ndone++;
+        printf ("[%d/%d] %s [%s]%s%s: %s, %.2lf sec, %ld nodes, gap %.4g%%\n", (int)ndone, (int)runs.size (),
+                basename_noext (r.instance).c_str (), r.config.c_str (),
+                r.timelimit.empty () ? "" : " time ", r.timelimit.c_str (),
+                r.status.c_str (), r.wall, r.nodes, 100*r.gap);
+    }
+
+    status = writeresults (out, runs);
+    if ( status ) {
+        printf ("ERROR: cannot write %s.csv / %s.json\n", out.c_str (), out.c_str ());
+        return status;
+    }
+    printf ("results written to %s.csv and %s.json\n", out.c_str (), out.c_str ());
+    return 0;
+}
@@ -8,10 +8,23 @@
 #include <cfloat>
 #include <cstring>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include <unistd.h>
 
 #include "cplex.h"
 
 #include "holes.hpp"
+#include "holeindex.hpp"
+#include "asynclog.hpp"
+#include "cbtiming.hpp"
+#include "cutpool.hpp"
+#include "mps.hpp"
+#include "nativebb.hpp"
+#include "pseudocost.hpp"
+#include "telemetry.hpp"
 #include "utils.hpp"
 
 struct Options {
@@ -64,21 +77,86 @@ struct Options {
     b_opt["br"] = std::make_pair(false, "Branch callback switch");
     keys["c"] = BoolKey;
     b_opt["c"] = std::make_pair(false, "Turn off cplex cuts");
+    keys["ctree"] = BoolKey;
+    b_opt["ctree"] = std::make_pair(false, "Separate one round of wide split cuts at every tree node");
+    keys["prop"] = BoolKey;
+    b_opt["prop"] = std::make_pair(false, "Move node bounds that lie in a hole to its edge, prune nodes without hole-free values (implies -br)");
+    keys["multiway"] = BoolKey;
+    b_opt["multiway"] = std::make_pair(false, "Branch on a rejected solution with one child per hole-free segment of the domain");
+    keys["select"] = BoolKey;
+    b_opt["select"] = std::make_pair(false, "Choose the branching variable among the hole variables by pseudo-costs (implies -br)");
+    keys["estlog"] = BoolKey;
+    b_opt["estlog"] = std::make_pair(false, "Log estimate and LP bound of every child of a hole branching");
+    keys["noholepre"] = BoolKey;
+    b_opt["noholepre"] = std::make_pair(false, "Use the holes as read, without merging, clipping and bound tightening");
+    keys["probe"] = BoolKey;
+    b_opt["probe"] = std::make_pair(false, "Probe the hole-free segments of every hole variable at the root");
+    keys["presolve"] = BoolKey;
+    b_opt["presolve"] = std::make_pair(false, "Keep cplex presolve on and apply the holes in the presolved model");
+    keys["convert"] = BoolKey;
+    b_opt["convert"] = std::make_pair(false, "Convert the hole file to binary format (_holes.bin) and exit");
     keys ["filter"] = BoolKey;
     b_opt["filter"] = std::make_pair(false, "Filter cuts (CPX_PURGE otherwise)");
     
     keys["n"] = IntKey;
     i_opt["n"] = std::make_pair(0, "Number of rounds of wide split cuts at root node");
+    keys["threads"] = IntKey;
+    i_opt["threads"] = std::make_pair(1, "Number of threads (0: let cplex decide)");
+    keys["maxchildren"] = IntKey;
+    i_opt["maxchildren"] = std::make_pair(8, "Maximum number of children of a multiway branching, segments are grouped beyond");
+    keys["sb"] = IntKey;
+    i_opt["sb"] = std::make_pair(0, "Number of hole variables to strong branch on (0: off, implies -select)");
+    keys["sbiter"] = IntKey;
+    i_opt["sbiter"] = std::make_pair(200, "Iteration limit of a strong branching child LP");
+    keys["sbdepth"] = IntKey;
+    i_opt["sbdepth"] = std::make_pair(10, "Deepest tree level with strong branching");
+    keys["repair"] = IntKey;
+    i_opt["repair"] = std::make_pair(0, "Run the hole repair heuristic at every k-th node (0: off)");
+    keys["probeiter"] = IntKey;
+    i_opt["probeiter"] = std::make_pair(1000, "Iteration limit of a probing LP");
+    keys["poolage"] = IntKey;
+    i_opt["poolage"] = std::make_pair(10, "Rounds a pooled wide split cut may stay slack before it is aged out");
+    keys["seed"] = IntKey;
+    i_opt["seed"] = std::make_pair(-1, "Random seed of cplex (-1: cplex default)");
     keys["log"] = IntKey;
     i_opt["log"] = std::make_pair(1, "log level");
+    keys["logbuf"] = IntKey;
+    i_opt["logbuf"] = std::make_pair(16384, "Log messages of the callbacks buffered per thread");
     
     keys["bab_time"] = DoubleKey;
     d_opt["bab_time"] = std::make_pair(DBL_MAX, "time limit in branch-and-bound");
 
+    keys["telemetry_interval"] = DoubleKey;
+    d_opt["telemetry_interval"] = std::make_pair(10, "Seconds between telemetry snapshots");
+
+    keys["sbtime"] = DoubleKey;
+    d_opt["sbtime"] = std::make_pair(60.0, "total time budget of the strong branching in seconds");
+
+    keys["probetime"] = DoubleKey;
+    d_opt["probetime"] = std::make_pair(60.0, "time budget of the root probing in seconds");
+
+    keys["cutoff"] = DoubleKey;
+    d_opt["cutoff"] = std::make_pair(1e+75, "objective value of a known solution, used by the probing and as cplex cutoff");
+
+    keys["poolmem"] = DoubleKey;
+    d_opt["poolmem"] = std::make_pair(64.0, "memory bound of the wide split cut pool in MB");
+
     keys["hfile"] = StringKey;
     stringset["hfile"] = false;
     s_opt["hfile"] = std::make_pair("instance_holes.txt", "holefile");
 
+    keys["backend"] = StringKey;
+    stringset["backend"] = false;
+    s_opt["backend"] = std::make_pair("cplex", "solver: cplex (callbacks) or native (built-in branch-and-bound, .mps only, no cplex license needed)");
+
+    keys["search"] = StringKey;
+    stringset["search"] = false;
+    s_opt["search"] = std::make_pair("best", "tree search of the native backend: best (best-bound with plunging) or dfs");
+
+    keys["telemetry"] = StringKey;
+    stringset["telemetry"] = false;
+    s_opt["telemetry"] = std::make_pair("", "file rewritten with a progress snapshot during the solve (Prometheus text format)");
+
     keys["logfile"] = StringKey;
     stringset["logfile"] = false;
     s_opt["logfile"] = std::make_pair("instance.bblog", "logfile");
@@ -128,100 +206,752 @@ struct Options {
   }
 };
 
-static int inccalled = 0;
-static int increjected = 0;
-static int brstr = 0;
-static int brchange = 0;
-static int npass = 0;
-static int cuts_tot = 0;
+/* Dense work arrays of the cut callback, sized from the node LP. */
+struct cutscratch {
+
+   cutscratch() :	x(NULL),
+			lb(NULL),
+			ub(NULL),
+			arow(NULL),
+			coef(NULL),
+			cutval(NULL),
+			rowval(NULL),
+			cstat(NULL),
+			cutind(NULL),
+			rowind(NULL),
+			brow(NULL),
+			rhs(NULL),
+			candscore(NULL),
+			rstat(NULL),
+			head(NULL),
+			cand(NULL),
+			sense(NULL),
+			colcap(0),
+			rowcap(0){}
+
+   double *x;         /* [ncols] */
+   double *lb;
+   double *ub;
+   double *arow;
+   double *coef;
+   double *cutval;
+   double *rowval;
+   int *cstat;
+   int *cutind;
+   int *rowind;
+   double *brow;      /* [nrows] */
+   double *rhs;
+   double *candscore;
+   int *rstat;
+   int *head;
+   int *cand;
+   char *sense;
+   int colcap;
+   int rowcap;
+};
+
+/* Working LP of one thread for the strong branching and the repair
+ * heuristic: the rows of the problem the callbacks see, without cuts,
+ * in an environment of its own so that it can be solved with its own
+ * parameters. */
+struct lpworker {
+
+   lpworker() :	env(NULL),
+			lp(NULL),
+			ind(NULL),
+			lu(NULL),
+			bd(NULL),
+			cstat(NULL),
+			rstat(NULL),
+			itlim(0){}
+
+   CPXENVptr env;
+   CPXLPptr lp;
+   int *ind;          /* [2*ncols] all columns twice, to set all bounds */
+   char *lu;
+   double *bd;
+   int *cstat;        /* basis of the node LP */
+   int *rstat;
+   int itlim;         /* iteration limit of a child LP */
+};
+
+/* Counters of one thread that the telemetry reads while the search
+ * runs. The thread copies its own counters here when it leaves a
+ * callback; all accesses are relaxed. */
+struct pubcounters {
+
+   pubcounters() :	inccalled(0),
+			increjected(0),
+			brstr(0),
+			brchange(0),
+			cuts_tot(0),
+			incns(0),
+			brns(0),
+			cutns(0),
+			heurns(0){}
+
+   std::atomic<int> inccalled;
+   std::atomic<int> increjected;
+   std::atomic<int> brstr;
+   std::atomic<int> brchange;
+   std::atomic<int> cuts_tot;
+   std::atomic<long long> incns;   /* CBTIMING: time in the callbacks */
+   std::atomic<long long> brns;
+   std::atomic<long long> cutns;
+   std::atomic<long long> heurns;
+   char pad[64];      /* keep the mirrors of different threads apart */
+};
+
+/* Callback state of one CPLEX thread. The incumbent callback that
+ * rejects a node solution and the branch callback of that node run on
+ * the same thread, so the rejection is passed on through the slot of
+ * that thread. The counters are summed up at the end of the run. */
+struct threadstate {
+
+   threadstate() :	inc_rejected(false),
+			varindex_found(0),
+			cpxvarindex_found(0),
+			holeindex_found(0),
+			inccalled(0),
+			increjected(0),
+			brstr(0),
+			brchange(0),
+			cuts_tot(0),
+			proptight(0),
+			proppruned(0),
+			mwbranch(0),
+			mwchildren(0),
+			selbranch(0),
+			seloverride(0),
+			sbcalls(0),
+			sblps(0),
+			sbinfeas(0),
+			sbpruned(0),
+			sbtime(0),
+			heurcalls(0),
+			heurfound(0),
+			heurimproved(0),
+			estcnt(0),
+			esterr(0),
+			estbias(0),
+			parerr(0),
+			varlu(NULL),
+			varbd(NULL),
+			mynodebeg(NULL),
+			bdcap(0),
+			nodecap(0),
+			childind(NULL),
+			childlu(NULL),
+			childbd(NULL),
+			childcap(0),
+			nodelb(NULL),
+			nodeub(NULL),
+			nodex(NULL),
+			propind(NULL),
+			proplu(NULL),
+			propbd(NULL),
+			segl(NULL),
+			segu(NULL),
+			candvar(NULL),
+			candhole(NULL),
+			candscore(NULL),
+			lastcutnode(-1),
+			log(NULL),
+			pub(NULL){}
+
+   bool inc_rejected;
+   int varindex_found;
+   int cpxvarindex_found;
+   int holeindex_found;
+   int inccalled;
+   int increjected;
+   int brstr;
+   int brchange;
+   int cuts_tot;
+   int proptight;     /* bounds tightened by the node propagation */
+   int proppruned;    /* nodes pruned by the node propagation */
+   int mwbranch;      /* multiway branchings */
+   int mwchildren;    /* children created by them */
+   int selbranch;     /* branchings on a selected hole variable */
+   int seloverride;   /* ... where cplex proposed another variable */
+   int sbcalls;       /* nodes with strong branching */
+   int sblps;         /* child LPs solved by it */
+   int sbinfeas;      /* infeasible segments found by it */
+   int sbpruned;      /* nodes pruned by it */
+   double sbtime;
+   int heurcalls;     /* calls of the repair heuristic */
+   int heurfound;     /* ... that found a feasible solution */
+   int heurimproved;  /* ... better than the incumbent */
+   int estcnt;        /* children whose estimate was compared to the bound */
+   double esterr;     /* sum of |bound - estimate| */
+   double estbias;    /* sum of bound - estimate */
+   double parerr;     /* sum of |bound - parent objective| */
+   char *varlu;       /* scratch buffers of the branch callback */
+   double *varbd;
+   int *mynodebeg;
+   int bdcap;
+   int nodecap;
+   int *childind;     /* bounds of one child including the propagated ones */
+   char *childlu;
+   double *childbd;
+   int childcap;
+   double *nodelb;    /* [ncols] local bounds of the node */
+   double *nodeub;
+   double *nodex;     /* [ncols] LP solution of the node */
+   int *propind;      /* [2*nvars] bounds tightened by the propagation */
+   char *proplu;
+   double *propbd;
+   double *segl;      /* [maxchildren] domain parts of a multiway branching */
+   double *segu;
+   int *candvar;      /* [sbcand] candidates of the variable selection */
+   int *candhole;
+   double *candscore;
+   lpworker lpw;
+   cutscratch cs;
+   int lastcutnode;   /* last tree node separated on this thread */
+   logring *log;      /* messages of the callbacks on this thread */
+   pubcounters *pub;  /* counters published to the telemetry */
+#ifdef CBTIMING
+   cblatency latinc;  /* latencies of the callbacks on this thread */
+   cblatency latbr;
+   cblatency latcut;
+   cblatency latheur;
+#endif
+   char pad[64];      /* keep the slots of different threads apart */
+};
+
+static std::atomic<int> npass(0);
+static std::atomic<long long> sbusec(0);  /* time spent in strong branching */
+
+/* Copies the counters of the thread that the telemetry reports to its
+ * published mirror. */
+static void
+publishcounters (const threadstate *ts){
+
+	pubcounters *pub = ts->pub;
+	if (pub == NULL) return;
+	pub->inccalled.store(ts->inccalled, std::memory_order_relaxed);
+	pub->increjected.store(ts->increjected, std::memory_order_relaxed);
+	pub->brstr.store(ts->brstr, std::memory_order_relaxed);
+	pub->brchange.store(ts->brchange, std::memory_order_relaxed);
+	pub->cuts_tot.store(ts->cuts_tot, std::memory_order_relaxed);
+#ifdef CBTIMING
+	pub->incns.store(ts->latinc.totalns, std::memory_order_relaxed);
+	pub->brns.store(ts->latbr.totalns, std::memory_order_relaxed);
+	pub->cutns.store(ts->latcut.totalns, std::memory_order_relaxed);
+	pub->heurns.store(ts->latheur.totalns, std::memory_order_relaxed);
+#endif
+}
+
+/* Publishes the counters when the callback is left; placed before
+ * CBTIME, so that the time of the callback is already recorded. */
+struct cbpublisher {
+
+   cbpublisher(const threadstate *t) :	ts(t){}
+   ~cbpublisher(){ publishcounters(ts); }
+
+   const threadstate *ts;
+};
+
+/* With CBTIMING, CBTIME(lat) times the rest of the callback it is
+ * placed in into the histogram lat of the thread; without it, the
+ * timing is compiled out entirely. */
+#ifdef CBTIMING
+#define CBTIME(lat)     cbtimer cbtime_(&(lat))
+#else
+#define CBTIME(lat)
+#endif
+
+#define MAXWSCUTS       100     /* wide split cuts per round and node */
+#define MAXCUTDYNAMISM  1E+09   /* max ratio of cut coefficients */
+
+/* slot of the calling thread, NULL if cplex does not report a thread
+ * number within the slots; the callback must then fail instead of
+ * sharing another thread's slot */
+static threadstate *
+getthreadstate (CPXCENVptr env,
+           void *cbdata,
+           int wherefrom,
+           threadstate *ts,
+           int nthreads){
+
+	int tid = 0;
+	if (nthreads > 1 &&
+	    CPXgetcallbackinfo(env, cbdata, wherefrom, CPX_CALLBACK_INFO_MY_THREAD_NUM, &tid)){
+		printf("ERROR: cannot get the thread number in a callback\n");
+		return NULL;
+	}
+	if (tid < 0 || tid >= nthreads){
+		printf("ERROR: callback on thread %d, state for %d threads only\n", tid, nthreads);
+		return NULL;
+	}
+	return ts + tid;
+}
+
+/* make sure the scratch buffers of a thread hold bdcnt bounds and
+ * nodecnt+1 node offsets; allocates only when they have to grow, at
+ * least by half, so they settle at the largest branching seen */
+static int
+reservescratch (threadstate *ts,
+           int bdcnt,
+           int nodecnt){
+
+	if (bdcnt > ts->bdcap){
+		bdcnt = XMAX(bdcnt, ts->bdcap + ts->bdcap/2);
+		char *varlu = (char*) realloc(ts->varlu, bdcnt*sizeof(char));
+		if (varlu == NULL) return ERR_NOMEMORY;
+		ts->varlu = varlu;
+		double *varbd = (double*) realloc(ts->varbd, bdcnt*sizeof(double));
+		if (varbd == NULL) return ERR_NOMEMORY;
+		ts->varbd = varbd;
+		ts->bdcap = bdcnt;
+	}
+	if (nodecnt+1 > ts->nodecap){
+		nodecnt = XMAX(nodecnt, ts->nodecap + ts->nodecap/2);
+		int *mynodebeg = (int*) realloc(ts->mynodebeg, (nodecnt+1)*sizeof(int));
+		if (mynodebeg == NULL) return ERR_NOMEMORY;
+		ts->mynodebeg = mynodebeg;
+		ts->nodecap = nodecnt+1;
+	}
+	return 0;
+}
+
+/* make sure a child can hold cnt bounds */
+static int
+reservechildscratch (threadstate *ts,
+           int cnt){
+
+	if (cnt > ts->childcap){
+		int *childind = (int*) realloc(ts->childind, cnt*sizeof(int));
+		if (childind == NULL) return ERR_NOMEMORY;
+		ts->childind = childind;
+		char *childlu = (char*) realloc(ts->childlu, cnt*sizeof(char));
+		if (childlu == NULL) return ERR_NOMEMORY;
+		ts->childlu = childlu;
+		double *childbd = (double*) realloc(ts->childbd, cnt*sizeof(double));
+		if (childbd == NULL) return ERR_NOMEMORY;
+		ts->childbd = childbd;
+		ts->childcap = cnt;
+	}
+	return 0;
+}
+
+/* scratch of the node propagation and the variable selection,
+ * allocated once for ncols columns and nvars hole variables */
+static int
+reservepropscratch (threadstate *ts,
+           int ncols,
+           int nvars){
+
+	ts->nodelb = (double*) malloc((ncols+1)*sizeof(double));
+	ts->nodeub = (double*) malloc((ncols+1)*sizeof(double));
+	ts->nodex = (double*) malloc((ncols+1)*sizeof(double));
+	ts->propind = (int*) malloc((2*nvars+1)*sizeof(int));
+	ts->proplu = (char*) malloc((2*nvars+1)*sizeof(char));
+	ts->propbd = (double*) malloc((2*nvars+1)*sizeof(double));
+	if ( ts->nodelb == NULL || ts->nodeub == NULL || ts->nodex == NULL || ts->propind == NULL ||
+	     ts->proplu == NULL || ts->propbd == NULL ) return ERR_NOMEMORY;
+	return reservechildscratch(ts, 2*nvars+2);
+}
+
+/* candidates of the variable selection, allocated once */
+static int
+reservecandscratch (threadstate *ts,
+           int ncand){
+
+	ts->candvar = (int*) malloc(ncand*sizeof(int));
+	ts->candhole = (int*) malloc(ncand*sizeof(int));
+	ts->candscore = (double*) malloc(ncand*sizeof(double));
+	if ( ts->candvar == NULL || ts->candhole == NULL || ts->candscore == NULL ) return ERR_NOMEMORY;
+	return 0;
+}
+
+static void
+freelpworker (lpworker *w){
+
+	if ( w->lp != NULL ) CPXfreeprob(w->env, &w->lp);
+	if ( w->env != NULL ) CPXcloseCPLEX(&w->env);
+	FREEN(&w->ind);
+	FREEN(&w->lu);
+	FREEN(&w->bd);
+	FREEN(&w->cstat);
+	FREEN(&w->rstat);
+}
+
+/* builds the working LP of a thread from the nrows rows
+ * rmatbeg/rmatind/rmatval and the bounds lb/ub of lp */
+static int
+createlpworker (lpworker *w,
+           CPXCENVptr env,
+           CPXCLPptr lp,
+           int nrows,
+           const int *rmatbeg,
+           const int *rmatind,
+           const double *rmatval,
+           const double *lb,
+           const double *ub,
+           int itlim){
+
+	int status = 0;
+	int ncols = CPXgetnumcols(env, lp);
+	double *obj = (double*) malloc((ncols+1)*sizeof(double));
+	double *rhs = (double*) malloc((nrows+1)*sizeof(double));
+	double *rng = (double*) malloc((nrows+1)*sizeof(double));
+	char *sense = (char*) malloc((nrows+1)*sizeof(char));
+	int *rngind = (int*) malloc((nrows+1)*sizeof(int));
+	int nrng = 0;
+
+	w->ind = (int*) malloc((2*ncols+1)*sizeof(int));
+	w->lu = (char*) malloc((2*ncols+1)*sizeof(char));
+	w->bd = (double*) malloc((2*ncols+1)*sizeof(double));
+	w->cstat = (int*) malloc((ncols+1)*sizeof(int));
+	w->rstat = (int*) malloc((nrows+1)*sizeof(int));
+	w->itlim = itlim;
+	if ( obj == NULL || rhs == NULL || rng == NULL || sense == NULL || rngind == NULL ||
+	     w->ind == NULL || w->lu == NULL || w->bd == NULL || w->cstat == NULL || w->rstat == NULL ) {
+		status = ERR_NOMEMORY;
+		goto TERMINATE;
+	}
+	for (int j=0; j<ncols; j++){
+		w->ind[j] = w->ind[ncols+j] = j;
+		w->lu[j] = 'L';
+		w->lu[ncols+j] = 'U';
+	}
+
+	status = CPXgetobj (env, lp, obj, 0, ncols-1);
+	if ( status ) goto TERMINATE;
+	if ( nrows > 0 ) {
+		status = CPXgetrhs (env, lp, rhs, 0, nrows-1);
+		if ( status ) goto TERMINATE;
+		status = CPXgetsense (env, lp, sense, 0, nrows-1);
+		if ( status ) goto TERMINATE;
+		status = CPXgetrngval (env, lp, rng, 0, nrows-1);
+		if ( status ) goto TERMINATE;
+	}
+	for (int r=0; r<nrows; r++){
+		if (sense[r] == 'R') rng[nrng] = rng[r], rngind[nrng++] = r;
+	}
+
+	w->env = CPXopenCPLEX (&status);
+	if ( status ) goto TERMINATE;
+	CPXsetintparam (w->env, CPX_PARAM_SCRIND, CPX_OFF);
+	CPXsetintparam (w->env, CPX_PARAM_THREADS, 1);
+	w->lp = CPXcreateprob (w->env, &status, "strongbranch");
+	if ( status ) goto TERMINATE;
+	status = CPXnewcols (w->env, w->lp, ncols, obj, lb, ub, NULL, NULL);
+	if ( status ) goto TERMINATE;
+	status = CPXaddrows (w->env, w->lp, 0, nrows, rmatbeg[nrows], rhs, sense, rmatbeg, rmatind, rmatval, NULL, NULL);
+	if ( status ) goto TERMINATE;
+	if ( nrng > 0 ) {
+		status = CPXchgrngval (w->env, w->lp, nrng, rngind, rng);
+		if ( status ) goto TERMINATE;
+	}
+	status = CPXchgobjsen (w->env, w->lp, CPXgetobjsen(env, lp));
+
+TERMINATE:
+
+	FREEN(&obj);
+	FREEN(&rhs);
+	FREEN(&rng);
+	FREEN(&sense);
+	FREEN(&rngind);
+
+	return status;
+}
+
+/* domain parts of a multiway branching, allocated once */
+static int
+reservesegscratch (threadstate *ts,
+           int maxchildren){
+
+	ts->segl = (double*) malloc(maxchildren*sizeof(double));
+	ts->segu = (double*) malloc(maxchildren*sizeof(double));
+	if ( ts->segl == NULL || ts->segu == NULL ) return ERR_NOMEMORY;
+	return 0;
+}
+
+static void
+freecutscratch (cutscratch *cs){
+
+	FREEN(&cs->x);
+	FREEN(&cs->lb);
+	FREEN(&cs->ub);
+	FREEN(&cs->arow);
+	FREEN(&cs->coef);
+	FREEN(&cs->cutval);
+	FREEN(&cs->rowval);
+	FREEN(&cs->cstat);
+	FREEN(&cs->cutind);
+	FREEN(&cs->rowind);
+	FREEN(&cs->brow);
+	FREEN(&cs->rhs);
+	FREEN(&cs->candscore);
+	FREEN(&cs->rstat);
+	FREEN(&cs->head);
+	FREEN(&cs->cand);
+	FREEN(&cs->sense);
+	cs->colcap = 0;
+	cs->rowcap = 0;
+}
+
+/* size the cut callback work arrays for ncols columns and nrows rows,
+ * the node LP grows by the cuts added so far */
+static int
+reservecutscratch (cutscratch *cs,
+           int ncols,
+           int nrows){
+
+	if (ncols > cs->colcap){
+		FREEN(&cs->x);
+		FREEN(&cs->lb);
+		FREEN(&cs->ub);
+		FREEN(&cs->arow);
+		FREEN(&cs->coef);
+		FREEN(&cs->cutval);
+		FREEN(&cs->rowval);
+		FREEN(&cs->cstat);
+		FREEN(&cs->cutind);
+		FREEN(&cs->rowind);
+		cs->x = (double*) malloc(ncols*sizeof(double));
+		cs->lb = (double*) malloc(ncols*sizeof(double));
+		cs->ub = (double*) malloc(ncols*sizeof(double));
+		cs->arow = (double*) malloc(ncols*sizeof(double));
+		cs->coef = (double*) malloc(ncols*sizeof(double));
+		cs->cutval = (double*) malloc(ncols*sizeof(double));
+		cs->rowval = (double*) malloc(ncols*sizeof(double));
+		cs->cstat = (int*) malloc(ncols*sizeof(int));
+		cs->cutind = (int*) malloc(ncols*sizeof(int));
+		cs->rowind = (int*) malloc(ncols*sizeof(int));
+		cs->colcap = ncols;
+		if ( cs->x == NULL || cs->lb == NULL || cs->ub == NULL ||
+		     cs->arow == NULL || cs->coef == NULL || cs->cutval == NULL ||
+		     cs->rowval == NULL || cs->cstat == NULL || cs->cutind == NULL ||
+		     cs->rowind == NULL ) {
+			freecutscratch(cs);
+			return ERR_NOMEMORY;
+		}
+	}
+	if (nrows > cs->rowcap){
+		// leave room for the cuts of the next rounds
+		nrows = nrows + nrows/4 + 16;
+		FREEN(&cs->brow);
+		FREEN(&cs->rhs);
+		FREEN(&cs->candscore);
+		FREEN(&cs->rstat);
+		FREEN(&cs->head);
+		FREEN(&cs->cand);
+		FREEN(&cs->sense);
+		cs->brow = (double*) malloc(nrows*sizeof(double));
+		cs->rhs = (double*) malloc(nrows*sizeof(double));
+		cs->candscore = (double*) malloc(nrows*sizeof(double));
+		cs->rstat = (int*) malloc(nrows*sizeof(int));
+		cs->head = (int*) malloc(nrows*sizeof(int));
+		cs->cand = (int*) malloc(nrows*sizeof(int));
+		cs->sense = (char*) malloc(nrows*sizeof(char));
+		cs->rowcap = nrows;
+		if ( cs->brow == NULL || cs->rhs == NULL || cs->candscore == NULL ||
+		     cs->rstat == NULL || cs->head == NULL || cs->cand == NULL ||
+		     cs->sense == NULL ) {
+			freecutscratch(cs);
+			return ERR_NOMEMORY;
+		}
+	}
+	return 0;
+}
+
+static void
+freescratch (threadstate *ts){
+
+	FREEN(&ts->varlu);
+	FREEN(&ts->varbd);
+	FREEN(&ts->mynodebeg);
+	ts->bdcap = 0;
+	ts->nodecap = 0;
+	FREEN(&ts->childind);
+	FREEN(&ts->childlu);
+	FREEN(&ts->childbd);
+	ts->childcap = 0;
+	FREEN(&ts->nodelb);
+	FREEN(&ts->nodeub);
+	FREEN(&ts->nodex);
+	FREEN(&ts->propind);
+	FREEN(&ts->proplu);
+	FREEN(&ts->propbd);
+	FREEN(&ts->segl);
+	FREEN(&ts->segu);
+	FREEN(&ts->candvar);
+	FREEN(&ts->candhole);
+	FREEN(&ts->candscore);
+	freelpworker(&ts->lpw);
+	freecutscratch(&ts->cs);
+}
 
-static bool inc_rejected = false;
-static int varindex_found = 0;
-static int cpxvarindex_found = 0;
-static int holeindex_found = 0;
+static void
+sumthreadstate (const threadstate *ts,
+           int nthreads,
+           threadstate *total){
+
+	*total = threadstate();
+	for (int t=0; t<nthreads; t++){
+		total->inccalled += ts[t].inccalled;
+		total->increjected += ts[t].increjected;
+		total->brstr += ts[t].brstr;
+		total->brchange += ts[t].brchange;
+		total->cuts_tot += ts[t].cuts_tot;
+		total->proptight += ts[t].proptight;
+		total->proppruned += ts[t].proppruned;
+		total->mwbranch += ts[t].mwbranch;
+		total->mwchildren += ts[t].mwchildren;
+		total->selbranch += ts[t].selbranch;
+		total->seloverride += ts[t].seloverride;
+		total->sbcalls += ts[t].sbcalls;
+		total->sblps += ts[t].sblps;
+		total->sbinfeas += ts[t].sbinfeas;
+		total->sbpruned += ts[t].sbpruned;
+		total->sbtime += ts[t].sbtime;
+		total->heurcalls += ts[t].heurcalls;
+		total->heurfound += ts[t].heurfound;
+		total->heurimproved += ts[t].heurimproved;
+		total->estcnt += ts[t].estcnt;
+		total->esterr += ts[t].esterr;
+		total->estbias += ts[t].estbias;
+		total->parerr += ts[t].parerr;
+#ifdef CBTIMING
+		mergelatency (&total->latinc, &ts[t].latinc);
+		mergelatency (&total->latbr, &ts[t].latbr);
+		mergelatency (&total->latcut, &ts[t].latcut);
+		mergelatency (&total->latheur, &ts[t].latheur);
+#endif
+	}
+}
 
 struct incumbentdata {
 
-   incumbentdata() : 	nvarswithholes(0),
-			lbvarswithholes(NULL),
-			ubvarswithholes(NULL),
-			nholesvarswithholes(NULL),
-			namevarswithholes(NULL),
-			lbholes(NULL),
-			ubholes(NULL),
+   incumbentdata() : 	holes(NULL),
 			ncols(0),
-			loglevel(0){}
-
-   int nvarswithholes;
-   double *lbvarswithholes;
-   double *ubvarswithholes;
-   int *nholesvarswithholes;
-   char **namevarswithholes;
-   double **lbholes;
-   double **ubholes;
-   std::map<std::string, int> name_to_index;
+			loglevel(0),
+			ts(NULL),
+			nthreads(1){}
+
+   const holeindex *holes;
    int ncols;
    int loglevel;
+   threadstate *ts;
+   int nthreads;
 };
 
 struct branchdata {
 
-	branchdata() : 	nvarswithholes(0),
-			lbvarswithholes(NULL),
-			ubvarswithholes(NULL),
-			nholesvarswithholes(NULL),
-			namevarswithholes(NULL),
-			lbholes(NULL),
-			ubholes(NULL),
+	branchdata() : 	holes(NULL),
 			ncols(0),
 			loglevel(0),
-			has_hole(NULL){}
-
-   int nvarswithholes;
-   double *lbvarswithholes;
-   double *ubvarswithholes;
-   int *nholesvarswithholes;
-   char **namevarswithholes;
-   double **lbholes;
-   double **ubholes;
-   std::map<std::string, int> name_to_index;
-   std::map<int, std::string> index_to_name;
-   std::map<int, int> index_to_index;
+			has_hole(NULL),
+			ts(NULL),
+			nthreads(1),
+			prop(false),
+			multiway(false),
+			maxchildren(2),
+			pc(NULL),
+			select(false),
+			estlog(false),
+			objsen(CPX_MIN),
+			sbcand(0),
+			sbdepth(0),
+			sbbudget(0){}
+
+   const holeindex *holes;
    int ncols;
    int loglevel;
    bool *has_hole;
+   threadstate *ts;
+   int nthreads;
+   bool prop;         /* propagate the holes into the node bounds */
+   bool multiway;     /* one child per hole-free segment on rejection */
+   int maxchildren;
+   pseudocost *pc;    /* degradation rates of the hole branchings */
+   bool select;       /* hole-aware variable selection */
+   bool estlog;       /* log estimate and bound of every hole child */
+   int objsen;
+   int sbcand;        /* strong branching candidates, 0 if off */
+   int sbdepth;       /* deepest tree level with strong branching */
+   double sbbudget;   /* total strong branching time in seconds */
+};
+
+/* Attached to the children of a hole branching, so that the
+ * pseudo-costs can be updated and the estimate be compared with the
+ * bound once the child LP is solved. */
+struct branchrecord {
+   int var;
+   bool up;
+   double dist;       /* distance the LP value is moved */
+   double parentobj;
+   double est;        /* estimated objective of the child */
+   int seqnum;
+   bool used;
+};
+
+struct heurdata {
+
+	heurdata() : 	holes(NULL),
+			ncols(0),
+			ctype(NULL),
+			glb(NULL),
+			gub(NULL),
+			objsen(CPX_MIN),
+			freq(0),
+			loglevel(0),
+			ts(NULL),
+			nthreads(1){}
+
+   const holeindex *holes;
+   int ncols;
+   char *ctype;
+   double *glb;       /* global column bounds */
+   double *gub;
+   int objsen;
+   int freq;          /* run at every freq-th node */
+   int loglevel;
+   threadstate *ts;
+   int nthreads;
 };
 
 struct cutdata {
 
-cutdata() : 	nvarswithholes(0),
-		lbvarswithholes(NULL),
-		ubvarswithholes(NULL),
-		nholesvarswithholes(NULL),
-		namevarswithholes(NULL),
-		lbholes(NULL),
-		ubholes(NULL),
+cutdata() : 	holes(NULL),
 		ncols(0),
 		maxpass(0),
 		ctype(NULL),
 		filter(0),
-		fout(NULL),
-		loglevel(0){}
-
-   int nvarswithholes;
-   double *lbvarswithholes;
-   double *ubvarswithholes;
-   int *nholesvarswithholes;
-   char **namevarswithholes;
-   double **lbholes;
-   double **ubholes;
-   std::map<std::string, int> name_to_index;
+		loglevel(0),
+		ts(NULL),
+		nthreads(1),
+		tree(false),
+		norigrows(0),
+		rmatbeg(NULL),
+		rmatind(NULL),
+		rmatval(NULL),
+		glb(NULL),
+		gub(NULL),
+		lastbound(0),
+		pool(NULL){}
+
+   const holeindex *holes;
    int ncols;
    int maxpass;
    char *ctype;
    int filter;
-   FILE *fout;
    int loglevel;
+   threadstate *ts;
+   int nthreads;
+   bool tree;         /* one round per node also in the tree */
+   int norigrows;     /* rows of the original problem, row-wise */
+   int *rmatbeg;
+   int *rmatind;
+   double *rmatval;
+   double *glb;       /* global column bounds */
+   double *gub;
+   double lastbound;  /* node bound of the previous root round */
+   cutpool *pool;     /* global cuts handed to cplex */
 };
 
 int CPXPUBLIC
@@ -236,41 +966,370 @@ int CPXPUBLIC
 
 	incumbentdata *inc = (incumbentdata*) cbhandle;
 
-	if (inc->loglevel>=3) printf("incumbentcallback called.\n");
+	threadstate *ts = getthreadstate(env, cbdata, wherefrom, inc->ts, inc->nthreads);
+	if (ts == NULL) return ERR_BADARGUMENT;
+	cbpublisher publish(ts);
+	CBTIME(ts->latinc);
+	ts->inccalled++;
 
-	inccalled++;
+	if (inc->loglevel>=3) logmsg(ts->log, LOG_SCREEN, "incumbentcallback called.\n");
+
+	const holeindex *holes = inc->holes;
 
 	int i = 0;
-	int j = 0;
 	int index = 0;
-	bool found = false;
 	// check whether any x[j] is in a hole
-	for(i=0; i<inc->nvarswithholes; i++){
-		index = inc->name_to_index[inc->namevarswithholes[i]];
-		for(j=0; j<inc->nholesvarswithholes[i]; j++){
-			if (x[index] > inc->lbholes[i][j] - 1 + EPSVIOL && x[index] < inc->ubholes[i][j] + 1 -EPSVIOL){
-				found = true;
-				break;
-			}
-		}
-		if (found) break;
-	}
+	int h = findviolation(holes, x, EPSVIOL, &i);
 
-	if (found) {
+	if (h >= 0) {
+		index = holes->col[i];
 		*isfeas_p = 0;
-		increjected++;
+		ts->increjected++;
 		if (wherefrom == CPX_CALLBACK_MIP_INCUMBENT_NODESOLN){
-			inc_rejected = true;
-			varindex_found = i;
-			cpxvarindex_found = index;
-			holeindex_found = j;
+			ts->inc_rejected = true;
+			ts->varindex_found = i;
+			ts->cpxvarindex_found = index;
+			ts->holeindex_found = h;
 		}
-		if (inc->loglevel>=1) printf("integer solution rejected.\n");
+		if (inc->loglevel>=1) logmsg(ts->log, LOG_SCREEN, "integer solution rejected.\n");
 	}
 
 	return 0;
 }
 
+/* Moves the local bounds of the node that lie in a hole to the edge of
+ * the hole. The tightened bounds are stored in the propagation scratch
+ * of the thread, *empty_p is set if the domain of a variable lies in
+ * its holes entirely. */
+static int
+propagateholes (CPXCENVptr env,
+           void *cbdata,
+           int wherefrom,
+           const branchdata *branch,
+           threadstate *ts,
+           int *ntight_p,
+           bool *empty_p){
+
+	const holeindex *holes = branch->holes;
+	int ntight = 0;
+
+	*ntight_p = 0;
+	*empty_p = false;
+
+	int status = CPXgetcallbacknodelb (env, cbdata, wherefrom, ts->nodelb, 0, branch->ncols-1);
+	if (status) return status;
+	status = CPXgetcallbacknodeub (env, cbdata, wherefrom, ts->nodeub, 0, branch->ncols-1);
+	if (status) return status;
+
+	for (int i=0; i<holes->nvars; i++){
+		int j = holes->col[i];
+		if (j < 0) continue;
+		double lo = ts->nodelb[j];
+		double up = ts->nodeub[j];
+		if (!snapholebounds(holes, i, &lo, &up)){
+			if (branch->loglevel>=2) logmsg(ts->log, LOG_SCREEN, "domain of %s lies in its holes, pruning node\n", holevarname(holes,i));
+			*empty_p = true;
+			return 0;
+		}
+		if (lo > ts->nodelb[j]){
+			ts->propind[ntight] = j;
+			ts->proplu[ntight] = 'L';
+			ts->propbd[ntight++] = lo;
+		}
+		if (up < ts->nodeub[j]){
+			ts->propind[ntight] = j;
+			ts->proplu[ntight] = 'U';
+			ts->propbd[ntight++] = up;
+		}
+	}
+	*ntight_p = ntight;
+	return 0;
+}
+
+/* Creates a child with the cnt bounds ind/lu/bd and the first ntight
+ * propagated bounds of the node. A propagated bound on a variable that
+ * the child bounds as well is merged into the child bound. */
+static int
+branchchild (CPXCENVptr env,
+           void *cbdata,
+           int wherefrom,
+           threadstate *ts,
+           int cnt,
+           const int *ind,
+           const char *lu,
+           const double *bd,
+           int ntight,
+           double est,
+           void *userhandle,
+           int *seqnr_p){
+
+	int status = reservechildscratch(ts, cnt+ntight);
+	if (status) return status;
+
+	int n = cnt;
+	for (int k=0; k<cnt; k++){
+		ts->childind[k] = ind[k];
+		ts->childlu[k] = lu[k];
+		ts->childbd[k] = bd[k];
+	}
+	for (int t=0; t<ntight; t++){
+		int k = 0;
+		while (k < cnt && (ind[k] != ts->propind[t] || (lu[k] != ts->proplu[t] && lu[k] != 'B'))) k++;
+		if (k == cnt){
+			ts->childind[n] = ts->propind[t];
+			ts->childlu[n] = ts->proplu[t];
+			ts->childbd[n++] = ts->propbd[t];
+		} else if (lu[k] == 'L'){
+			ts->childbd[k] = XMAX(ts->childbd[k], ts->propbd[t]);
+		} else if (lu[k] == 'U'){
+			ts->childbd[k] = XMIN(ts->childbd[k], ts->propbd[t]);
+		}
+	}
+
+	int seqnr = 0;
+	status = CPXbranchcallbackbranchbds (env, cbdata, wherefrom, n, ts->childind, ts->childlu, ts->childbd, est, userhandle, &seqnr);
+	if (seqnr_p != NULL) *seqnr_p = seqnr;
+	return status;
+}
+
+/* Record of a child of a hole branching on variable i that moves the
+ * LP value by dist, with the estimate parentobj plus the expected
+ * degradation. Returns NULL if out of memory. */
+static branchrecord *
+newbranchrecord (const branchdata *branch,
+           int i,
+           bool up,
+           double dist,
+           double parentobj){
+
+	branchrecord *rec = (branchrecord*) malloc(sizeof(branchrecord));
+	if (rec == NULL) return NULL;
+	rec->var = i;
+	rec->up = up;
+	rec->dist = dist;
+	rec->parentobj = parentobj;
+	rec->est = parentobj + branch->objsen*pseudocostrate(branch->pc, i, up)*dist;
+	rec->seqnum = -1;
+	rec->used = false;
+	return rec;
+}
+
+/* Two-way branching x <= lb-1 / x >= ub+1 on hole h of variable i,
+ * whose LP value at the node is v. With the variable selection on,
+ * the children carry a record for the pseudo-cost update. */
+static int
+holebranch (CPXCENVptr env,
+           void *cbdata,
+           int wherefrom,
+           const branchdata *branch,
+           threadstate *ts,
+           int i,
+           int h,
+           double v,
+           int ntight){
+
+	const holeindex *holes = branch->holes;
+	int j = holes->col[i];
+	char lu[2] = {'U', 'L'};
+	double bd[2] = {holes->lb[h]-1, holes->ub[h]+1};
+	double objval = 0;
+
+	int status = CPXgetcallbacknodeobjval (env, cbdata, wherefrom, &objval);
+	if (status) return status;
+	for (int c=0; c<2; c++){
+		branchrecord *rec = newbranchrecord(branch, i, c == 1, (c == 0) ? v-bd[0] : bd[1]-v, objval);
+		if (rec == NULL) return ERR_NOMEMORY;
+		status = branchchild(env, cbdata, wherefrom, ts, 1, &j, lu+c, bd+c, ntight, rec->est, rec, &rec->seqnum);
+		if (status){
+			free(rec);
+			return status;
+		}
+	}
+	if (branch->loglevel>=2){
+		logmsg(ts->log, LOG_SCREEN, "branching on variable with hole, setting new bounds to %.2lf / %.2lf\n", bd[0], bd[1]);
+	}
+	return 0;
+}
+
+/* updates the pseudo-costs and the estimate statistics from the record
+ * of the node, if the node is a child of a hole branching */
+static int
+learnpseudocost (CPXCENVptr env,
+           void *cbdata,
+           int wherefrom,
+           const branchdata *branch,
+           threadstate *ts){
+
+	branchrecord *rec = NULL;
+	int status = CPXgetcallbacknodeinfo (env, cbdata, wherefrom, 0, CPX_CALLBACK_INFO_NODE_USERHANDLE, &rec);
+	if (status || rec == NULL || rec->used) return status;
+
+	double objval = 0;
+	status = CPXgetcallbacknodeobjval (env, cbdata, wherefrom, &objval);
+	if (status) return status;
+	ts->estcnt++;
+	ts->esterr += XABS(objval - rec->est);
+	ts->estbias += objval - rec->est;
+	ts->parerr += XABS(objval - rec->parentobj);
+	if (branch->estlog){
+		logmsg(ts->log, LOG_FILE, "child %d %s %s %.2lf: parent %.6lf estimate %.6lf bound %.6lf\n",
+			rec->seqnum, holevarname(branch->holes,rec->var), rec->up ? "up" : "down", rec->dist,
+			rec->parentobj, rec->est, objval);
+	}
+	// the estimate of later children uses the updated rate
+	updatepseudocost(branch->pc, rec->var, rec->up, rec->dist, branch->objsen*(objval - rec->parentobj));
+	rec->used = true;
+	return 0;
+}
+
+/* adds the bound lu/bd on column j to the tightened bounds of the node */
+static void
+addtightening (threadstate *ts,
+           int *ntight_p,
+           int j,
+           char lu,
+           double bd){
+
+	for (int t=0; t<*ntight_p; t++){
+		if (ts->propind[t] == j && ts->proplu[t] == lu){
+			ts->propbd[t] = (lu == 'L') ? XMAX(ts->propbd[t], bd) : XMIN(ts->propbd[t], bd);
+			return;
+		}
+	}
+	ts->propind[*ntight_p] = j;
+	ts->proplu[*ntight_p] = lu;
+	ts->propbd[(*ntight_p)++] = bd;
+}
+
+/* Strong branching over the wide split disjunctions of the ncand
+ * candidates of the variable selection: both children of each
+ * candidate are solved in the working LP with the local bounds of the
+ * node and an iteration limit. A child found infeasible tightens the
+ * node bounds, two infeasible children prune the node; infeasible
+ * children are counted for the variable selection, not as gains in the
+ * pseudo-costs. The candidate
+ * with the best product of the objective gains is returned in
+ * *selvar_p and *selh_p, -1 if none has two feasible children. */
+static int
+strongbranch (CPXCENVptr env,
+           void *cbdata,
+           int wherefrom,
+           const branchdata *branch,
+           threadstate *ts,
+           int ncand,
+           int *ntight_p,
+           int *selvar_p,
+           int *selh_p,
+           bool *pruned_p){
+
+	const holeindex *holes = branch->holes;
+	lpworker *w = &ts->lpw;
+	int n = branch->ncols;
+	int depth = 0;
+	double starttime = 0;
+	double endtime = 0;
+	double parentobj = 0;
+	double bestscore = -1;
+
+	*pruned_p = false;
+	int status = CPXgetcallbacknodeinfo (env, cbdata, wherefrom, 0, CPX_CALLBACK_INFO_NODE_DEPTH, &depth);
+	if (status || depth > branch->sbdepth || sbusec.load() >= branch->sbbudget*1e+06) return status;
+	CPXgettime(env, &starttime);
+	ts->sbcalls++;
+
+	// the working LP gets the local bounds of the node, solved to optimality
+	for (int j=0; j<n; j++){
+		w->bd[j] = ts->nodelb[j];
+		w->bd[n+j] = ts->nodeub[j];
+	}
+	status = CPXchgbds (w->env, w->lp, 2*n, w->ind, w->lu, w->bd);
+	if (status) goto TERMINATE;
+	if (*ntight_p > 0){
+		status = CPXchgbds (w->env, w->lp, *ntight_p, ts->propind, ts->proplu, ts->propbd);
+		if (status) goto TERMINATE;
+	}
+	CPXsetintparam (w->env, CPX_PARAM_ITLIM, 2100000000);
+	status = CPXdualopt (w->env, w->lp);
+	if (status) goto TERMINATE;
+	if (CPXgetstat(w->env, w->lp) == CPX_STAT_INFEASIBLE){
+		*pruned_p = true;
+		goto TERMINATE;
+	}
+	if (CPXgetstat(w->env, w->lp) != CPX_STAT_OPTIMAL) goto TERMINATE;
+	status = CPXgetobjval (w->env, w->lp, &parentobj);
+	if (status) goto TERMINATE;
+	status = CPXgetbase (w->env, w->lp, w->cstat, w->rstat);
+	if (status) goto TERMINATE;
+	CPXsetintparam (w->env, CPX_PARAM_ITLIM, w->itlim);
+
+	*selvar_p = -1;
+	for (int c=0; c<ncand; c++){
+		int i = ts->candvar[c];
+		int h = ts->candhole[c];
+		int j = holes->col[i];
+		double v = ts->nodex[j];
+		char lu[2] = {'U', 'L'};
+		double bd[2] = {holes->lb[h]-1, holes->ub[h]+1};
+		double gain[2] = {0, 0};
+		bool infeas[2] = {false, false};
+
+		for (int side=0; side<2; side++){
+			double old = 0;
+			double objval = 0;
+			status = (side == 0) ? CPXgetub (w->env, w->lp, &old, j, j) : CPXgetlb (w->env, w->lp, &old, j, j);
+			if (status) goto TERMINATE;
+			status = CPXcopybase (w->env, w->lp, w->cstat, w->rstat);
+			if (status) goto TERMINATE;
+			status = CPXchgbds (w->env, w->lp, 1, &j, lu+side, bd+side);
+			if (status) goto TERMINATE;
+			status = CPXdualopt (w->env, w->lp);
+			if (status) goto TERMINATE;
+			ts->sblps++;
+			// the dual objective at the iteration limit is still a bound
+			infeas[side] = (CPXgetstat(w->env, w->lp) == CPX_STAT_INFEASIBLE);
+			if (!infeas[side] && CPXgetobjval (w->env, w->lp, &objval) == 0)
+				gain[side] = XMAX(branch->objsen*(objval - parentobj), 0.0);
+			status = CPXchgbds (w->env, w->lp, 1, &j, lu+side, &old);
+			if (status) goto TERMINATE;
+		}
+		if (infeas[0]) addpseudocostinfeas(branch->pc, i);
+		if (infeas[1]) addpseudocostinfeas(branch->pc, i);
+
+		if (infeas[0] && infeas[1]){
+			ts->sbinfeas += 2;
+			*pruned_p = true;
+			goto TERMINATE;
+		}
+		if (infeas[0] || infeas[1]){
+			// the remaining segment is a bound for the node and the working LP
+			int side = infeas[0] ? 1 : 0;
+			ts->sbinfeas++;
+			addtightening(ts, ntight_p, j, lu[side], bd[side]);
+			status = CPXchgbds (w->env, w->lp, 1, &j, lu+side, bd+side);
+			if (status) goto TERMINATE;
+			if (branch->loglevel>=2) logmsg(ts->log, LOG_SCREEN, "strong branching: segment of %s infeasible, new bound %c %.2lf\n",
+							 holevarname(holes,i), lu[side], bd[side]);
+			continue;
+		}
+		updatepseudocost(branch->pc, i, false, v-bd[0], gain[0]);
+		updatepseudocost(branch->pc, i, true, bd[1]-v, gain[1]);
+		double score = XMAX(gain[0], 1e-06)*XMAX(gain[1], 1e-06);
+		if (score > bestscore){
+			bestscore = score;
+			*selvar_p = i;
+			*selh_p = h;
+		}
+	}
+
+TERMINATE:
+
+	CPXgettime(env, &endtime);
+	ts->sbtime += endtime-starttime;
+	sbusec += (long long)((endtime-starttime)*1e+06);
+
+	return status;
+}
+
 int CPXPUBLIC
  hole_branchcallback (CPXCENVptr env,
            void *cbdata,
@@ -290,59 +1349,164 @@ int CPXPUBLIC
 	*useraction_p = CPX_CALLBACK_DEFAULT;
 
 	branchdata *branch = (branchdata*) cbhandle;
+	const holeindex *holes = branch->holes;
+
+	threadstate *ts = getthreadstate(env, cbdata, wherefrom, branch->ts, branch->nthreads);
+	if (ts == NULL) return ERR_BADARGUMENT;
+	cbpublisher publish(ts);
+	CBTIME(ts->latbr);
 
 	// get a local copy of inc_rejected and reset it
-	bool rejected = inc_rejected;
-	inc_rejected = false;
+	bool rejected = ts->inc_rejected;
+	ts->inc_rejected = false;
 
-	if (branch->loglevel>=3) printf("branchcallback called, branchtype: %c. inc_rejected: %d.\n",type,rejected);
+	if (branch->loglevel>=3) logmsg(ts->log, LOG_SCREEN, "branchcallback called, branchtype: %c. inc_rejected: %d.\n",type,rejected);
 
 	int status = 0;
 
-	int *mynodebeg = NULL;
-
 	bool enforce = false;
 	int cnt = 0;
 
-	char *varlu = NULL;
-	double *varbd = NULL;
+	char *varlu = ts->varlu;
+	double *varbd = ts->varbd;
+	int *mynodebeg = ts->mynodebeg;
+	int ntight = 0;
+	int selvar = -1;
+	int selh = -1;
 
-	double *x = NULL;
+	if (branch->pc != NULL){
+		status = learnpseudocost(env, cbdata, wherefrom, branch, ts);
+		if (status) goto TERMINATE;
+	}
 
-	if (rejected){ // branch on the variable detected in the inccb
-		varlu = (char*) malloc(2*sizeof(char));
-		varbd = (double*) malloc(2*sizeof(double));
+	if (branch->prop){
+		bool empty = false;
+		status = propagateholes(env, cbdata, wherefrom, branch, ts, &ntight, &empty);
+		if (status) goto TERMINATE;
+		if (empty){ // no children: the node is pruned
+			ts->proppruned++;
+			*useraction_p = CPX_CALLBACK_SET;
+			goto TERMINATE;
+		}
+	}
 
-		varlu[0] = 'U';
-		varlu[1] = 'L';
-		varbd[0] = branch->lbholes[varindex_found][holeindex_found]-1;
-		varbd[1] = branch->ubholes[varindex_found][holeindex_found]+1;
-		double est = 0; //adjust this
-		status = CPXgetcallbacknodeobjval (env, cbdata, wherefrom, &est);
+	// pick the hole variable to branch on when cplex is about to branch
+	if (branch->select && !rejected && nodecnt > 0){
+		status = CPXgetcallbacknodex (env, cbdata, wherefrom, ts->nodex, 0, branch->ncols-1);
 		if (status) goto TERMINATE;
-		for (int c=0; c<2; c++){
-			int seqnr = 0; //adjust this
-			status = CPXbranchcallbackbranchbds( env, cbdata, wherefrom, 1, &cpxvarindex_found, varlu+c, varbd+c, est, NULL, &seqnr);
+		if (!branch->prop){
+			status = CPXgetcallbacknodelb (env, cbdata, wherefrom, ts->nodelb, 0, branch->ncols-1);
+			if (status) goto TERMINATE;
+			status = CPXgetcallbacknodeub (env, cbdata, wherefrom, ts->nodeub, 0, branch->ncols-1);
 			if (status) goto TERMINATE;
 		}
-		brchange++;
+		int ncand = selectholevars(holes, branch->pc, ts->nodex, ts->nodelb, ts->nodeub,
+					   XMAX(branch->sbcand, 1), ts->candvar, ts->candhole, ts->candscore);
+		if (ncand > 0){
+			selvar = ts->candvar[0];
+			selh = ts->candhole[0];
+		}
+		if (ncand > 0 && branch->sbcand > 0){
+			bool pruned = false;
+			status = strongbranch(env, cbdata, wherefrom, branch, ts, ncand, &ntight, &selvar, &selh, &pruned);
+			if (status) goto TERMINATE;
+			if (pruned){ // no children: the node is pruned
+				ts->sbpruned++;
+				*useraction_p = CPX_CALLBACK_SET;
+				goto TERMINATE;
+			}
+		}
+	}
+
+	if (rejected && branch->multiway){ // one child per hole-free part of the domain
+		int j = ts->cpxvarindex_found;
+		double lo, up;
+		status = CPXgetcallbacknodelb (env, cbdata, wherefrom, &lo, j, j);
+		if (status) goto TERMINATE;
+		status = CPXgetcallbacknodeub (env, cbdata, wherefrom, &up, j, j);
+		if (status) goto TERMINATE;
+		double objval = 0;
+		double v = 0;
+		status = CPXgetcallbacknodeobjval (env, cbdata, wherefrom, &objval);
+		if (status) goto TERMINATE;
+		status = CPXgetcallbacknodex (env, cbdata, wherefrom, &v, j, j);
+		if (status) goto TERMINATE;
+		// the hole of v separates two parts, so every child cuts off v
+		int nparts = holesegments(holes, ts->varindex_found, lo, up, v, branch->maxchildren, ts->segl, ts->segu);
+		for (int p=0; p<nparts; p++){
+			int segind[2] = {j, j};
+			char seglu[2] = {'L', 'U'};
+			double segbd[2] = {ts->segl[p], ts->segu[p]};
+			// distance from v to the nearest edge of the part, 0 if v lies in it
+			bool segup = ts->segl[p] > v;
+			double segdist = segup ? ts->segl[p]-v : XMAX(v-ts->segu[p], 0.0);
+			branchrecord *rec = newbranchrecord(branch, ts->varindex_found, segup, segdist, objval);
+			if (rec == NULL){
+				status = ERR_NOMEMORY;
+				goto TERMINATE;
+			}
+			status = branchchild(env, cbdata, wherefrom, ts, 2, segind, seglu, segbd, ntight, rec->est, rec, &rec->seqnum);
+			if (status){
+				free(rec);
+				goto TERMINATE;
+			}
+		}
+		ts->brchange++;
+		ts->mwbranch++;
+		ts->mwchildren += nparts;
+		ts->proptight += ntight;
 		if (branch->loglevel>=2){
-					printf("branching on variable with hole, setting new bounds to %.2lf / %.2lf\n",
-					varbd[0],varbd[1]);
+			logmsg(ts->log, LOG_SCREEN, "multiway branching on %s, %d children\n", holevarname(holes,ts->varindex_found), nparts);
 		}
+	} else if (rejected){ // branch on the variable detected in the inccb
+		double v = 0;
+		status = CPXgetcallbacknodex (env, cbdata, wherefrom, &v, ts->cpxvarindex_found, ts->cpxvarindex_found);
+		if (status) goto TERMINATE;
+		status = holebranch(env, cbdata, wherefrom, branch, ts, ts->varindex_found, ts->holeindex_found, v, ntight);
+		if (status) goto TERMINATE;
+		ts->brchange++;
+		ts->proptight += ntight;
+	} else if (selvar >= 0){ // branch on the selected hole variable
+		status = holebranch(env, cbdata, wherefrom, branch, ts, selvar, selh, ts->nodex[holes->col[selvar]], ntight);
+		if (status) goto TERMINATE;
+		ts->selbranch++;
+		if (type != CPX_TYPE_VAR || bdcnt == 0 || indices[0] != holes->col[selvar]) ts->seloverride++;
+		ts->proptight += ntight;
+	} else if (type != CPX_TYPE_VAR && nodecnt > 0){
+		// the children of other branchings cannot be rebuilt with the
+		// tightened bounds, so the node is re-solved with them in a
+		// single child, which cplex then branches on itself
+		if (ntight == 0) goto TERMINATE;
+		double objval = 0;
+		status = CPXgetcallbacknodeobjval (env, cbdata, wherefrom, &objval);
+		if (status) goto TERMINATE;
+		status = branchchild(env, cbdata, wherefrom, ts, 0, NULL, NULL, NULL, ntight, objval, NULL, NULL);
+		if (status) goto TERMINATE;
+		ts->proptight += ntight;
 	} else { // see whether the cplex branching can be strengthened
-		if (type != CPX_TYPE_VAR || nodecnt == 0) goto TERMINATE;
+		// without children the node is fathomed, there is no subtree
+		// the tightened bounds could help
+		if (nodecnt == 0) goto TERMINATE;
+
+		/* nothing to do unless cplex branches on a variable with holes */
+		int first = 0;
+		while (first < bdcnt && (lu[first] == 'B' || branch->has_hole[indices[first]] != TRUE)) first++;
+		if (first == bdcnt && ntight == 0) goto TERMINATE;
+
+		if (bdcnt > ts->bdcap || nodecnt+1 > ts->nodecap){
+			status = reservescratch(ts, bdcnt, nodecnt);
+			if (status) goto TERMINATE;
+			varlu = ts->varlu;
+			varbd = ts->varbd;
+			mynodebeg = ts->mynodebeg;
+		}
 
 		/* copy the branching data */
-		varlu = (char*) malloc(bdcnt*sizeof(char));
-		varbd = (double*) malloc(bdcnt*sizeof(double));
 		for (int k=0; k<bdcnt; k++){
 			varbd[k] = bd[k];
 			varlu[k] = lu[k];
 		}
 
-		mynodebeg = (int *) malloc ((nodecnt+1) * sizeof (int));
-		if (mynodebeg == NULL) goto TERMINATE;
 		for (int c=0; c<nodecnt; c++){
 			mynodebeg[c] = nodebeg[c];
 		}
@@ -355,34 +1519,31 @@ int CPXPUBLIC
 				if (lu[k] == 'B') continue;
 				int varind = indices[k];
 				if (branch->has_hole[varind] == TRUE) {
-					int i = branch->index_to_index[varind];
-					for(int j=0; j<branch->nholesvarswithholes[i]; j++){
-						if ( bd[k] > branch->lbholes[i][j]-1 && bd[k] < branch->ubholes[i][j]+1){
-							varbd[k] = (lu[k] == 'L') ? branch->ubholes[i][j]+1 : branch->lbholes[i][j]-1;
-							varlu[k] = lu[k];
-							enforce = true;
-							brstr++;
-							if (branch->loglevel>=2){
-								printf("cplex branching on variable with hole: %s, suggested new %c to %.2lf,\n",
-								branch->namevarswithholes[i],lu[k],bd[k]);
-								printf("\tthat's in a hole. setting new bound to %.2lf\n",varbd[k]);
-							}
-							break;
+					int i = holes->colvar[varind];
+					int h = findhole(holes, i, bd[k], 0.0);
+					if (h >= 0){
+						varbd[k] = (lu[k] == 'L') ? holes->ub[h]+1 : holes->lb[h]-1;
+						varlu[k] = lu[k];
+						enforce = true;
+						ts->brstr++;
+						if (branch->loglevel>=2){
+							logmsg(ts->log, LOG_SCREEN, "cplex branching on variable with hole: %s, suggested new %c to %.2lf,\n"
+							       "\tthat's in a hole. setting new bound to %.2lf\n",holevarname(holes,i),lu[k],bd[k],varbd[k]);
 						}
 					}
 				}
 			}
 		}
 
-		if (enforce == true){
+		if (enforce == true || ntight > 0){
 			cnt = 0;
 			for (int c=0; c<nodecnt; c++){
-				int seqnr = 0;
-				status = CPXbranchcallbackbranchbds( env, cbdata, wherefrom, mynodebeg[c+1]-mynodebeg[c],
-							 indices+cnt, varlu+cnt, varbd+cnt, nodeest[c], NULL, &seqnr);
+				status = branchchild(env, cbdata, wherefrom, ts, mynodebeg[c+1]-mynodebeg[c],
+						     indices+cnt, varlu+cnt, varbd+cnt, ntight, nodeest[c], NULL, NULL);
 				if (status) goto TERMINATE;
 				cnt += mynodebeg[c+1]-mynodebeg[c];
 			}
+			ts->proptight += ntight;
 		} else {
 			goto TERMINATE;
 		}
@@ -392,10 +1553,154 @@ int CPXPUBLIC
 
 TERMINATE:
 
-	FREEN(&varlu);
-	FREEN(&varbd);
-	FREEN(&mynodebeg);
-	FREEN(&x);
+	return status;
+}
+
+/* Wide split cut from row p of the optimal tableau of the node LP,
+ * whose basic variable has value f, and the disjunction
+ * x <= pi0 or x >= pi1. With t_k >= 0 the distances of the nonbasic
+ * variables from their bounds, the basic variable moves by a_k per
+ * unit of t_k, and the intersection cut is
+ *   sum_k max(a_k/(pi1-f), -a_k/(f-pi0)) t_k >= 1,
+ * which is written back in the structural variables. On return, *nz_p
+ * is the number of nonzeros in cs->cutind/cs->cutval (0 if no cut),
+ * *local_p tells whether a bound used is tighter than the global one. */
+static int
+widesplitcut (CPXCENVptr env,
+           CPXCLPptr nodelp,
+           const cutdata *cut,
+           cutscratch *cs,
+           int nrows,
+           int p,
+           double f,
+           double pi0,
+           double pi1,
+           int *nz_p,
+           double *rhs_p,
+           double *viol_p,
+           bool *local_p){
+
+	int status = 0;
+	int ncols = cut->ncols;
+	double rhs = 1.0;
+	bool local = false;
+	double *coef = cs->coef;
+
+	*nz_p = 0;
+
+	status = CPXbinvarow (env, nodelp, p, cs->arow);
+	if (status) goto TERMINATE;
+	status = CPXbinvrow (env, nodelp, p, cs->brow);
+	if (status) goto TERMINATE;
+
+	for (int k=0; k<ncols; k++) coef[k] = 0.0;
+
+	for (int k=0; k<ncols; k++){
+		double a = cs->arow[k];
+		if (cs->cstat[k] == CPX_BASIC || XABS(a) < EPSZERO) continue;
+		if (cs->ub[k] - cs->lb[k] < EPSZERO) continue;
+		if (cs->cstat[k] == CPX_AT_LOWER){
+			// x_k = lb_k + t
+			double gamma = (-a > 0) ? -a/(pi1-f) : a/(f-pi0);
+			coef[k] += gamma;
+			rhs += gamma*cs->lb[k];
+			if (cs->lb[k] > cut->glb[k]) local = true;
+		} else if (cs->cstat[k] == CPX_AT_UPPER){
+			// x_k = ub_k - t
+			double gamma = (a > 0) ? a/(pi1-f) : -a/(f-pi0);
+			coef[k] -= gamma;
+			rhs -= gamma*cs->ub[k];
+			if (cs->ub[k] < cut->gub[k]) local = true;
+		} else {
+			// free or superbasic nonbasic variable, no ray to follow
+			goto TERMINATE;
+		}
+	}
+
+	for (int i=0; i<nrows; i++){
+		double a = cs->brow[i];
+		double gamma = 0;
+		double sign = 0;
+		if (cs->rstat[i] == CPX_BASIC || XABS(a) < EPSZERO) continue;
+		switch (cs->sense[i]){
+			case 'E':
+				continue;
+			case 'L':
+				// slack rhs - a x = t >= 0
+				gamma = (-a > 0) ? -a/(pi1-f) : a/(f-pi0);
+				sign = -1;
+				break;
+			case 'G':
+				// slack rhs - a x = -t <= 0
+				gamma = (a > 0) ? a/(pi1-f) : -a/(f-pi0);
+				sign = 1;
+				break;
+			default:
+				goto TERMINATE;
+		}
+		const int *rowind = NULL;
+		const double *rowval = NULL;
+		int rownz = 0;
+		if (i < cut->norigrows){
+			rowind = cut->rmatind + cut->rmatbeg[i];
+			rowval = cut->rmatval + cut->rmatbeg[i];
+			rownz = cut->rmatbeg[i+1] - cut->rmatbeg[i];
+		} else {
+			// a cut row of the node LP, which may be valid in this
+			// subtree only, so the derived cut is local as well
+			local = true;
+			int rmatbeg = 0;
+			int surplus = 0;
+			status = CPXgetrows (env, nodelp, &rownz, &rmatbeg, cs->rowind, cs->rowval, ncols, &surplus, i, i);
+			if (status) goto TERMINATE;
+			rowind = cs->rowind;
+			rowval = cs->rowval;
+		}
+		for (int k=0; k<rownz; k++) coef[rowind[k]] += sign*gamma*rowval[k];
+		rhs += sign*gamma*cs->rhs[i];
+	}
+
+	{
+		// collect the nonzeros; tiny coefficients are moved to the
+		// right hand side using the variable bounds
+		int nz = 0;
+		double lhs = 0;
+		double norm = 0;
+		double maxabs = 0;
+		double minabs = DBL_MAX;
+		for (int k=0; k<ncols; k++){
+			double c = coef[k];
+			if (c == 0.0) continue;
+			if (XABS(c) < EPSZERO){
+				if (c > 0 && cs->ub[k] < CPX_INFBOUND){
+					rhs -= c*cs->ub[k];
+					if (cs->ub[k] < cut->gub[k]) local = true;
+					continue;
+				}
+				if (c < 0 && cs->lb[k] > -CPX_INFBOUND){
+					rhs -= c*cs->lb[k];
+					if (cs->lb[k] > cut->glb[k]) local = true;
+					continue;
+				}
+			}
+			cs->cutind[nz] = k;
+			cs->cutval[nz] = c;
+			lhs += c*cs->x[k];
+			norm += c*c;
+			maxabs = XMAX(maxabs, XABS(c));
+			minabs = XMIN(minabs, XABS(c));
+			nz++;
+		}
+		if (nz == 0 || maxabs > MAXCUTDYNAMISM*minabs) goto TERMINATE;
+		norm = sqrt(norm);
+		if ((rhs - lhs)/norm < EPSVIOL) goto TERMINATE;
+		*nz_p = nz;
+		*rhs_p = rhs;
+		*viol_p = (rhs - lhs)/norm;
+		*local_p = local;
+	}
+
+TERMINATE:
 
 	return status;
 }
@@ -407,9 +1712,124 @@ int CPXPUBLIC
            void *cbhandle,
            int *useraction_p){
 
+	*useraction_p = CPX_CALLBACK_DEFAULT;
+
+	cutdata *cut = (cutdata*) cbhandle;
+	const holeindex *holes = cut->holes;
+
+	threadstate *ts = getthreadstate(env, cbdata, wherefrom, cut->ts, cut->nthreads);
+	if (ts == NULL) return ERR_BADARGUMENT;
+	cbpublisher publish(ts);
+	CBTIME(ts->latcut);
+	cutscratch *cs = &ts->cs;
+
 	int status = 0;
-     
-    /* insert your cut separation here */
+
+	CPXLPptr nodelp = NULL;
+	int ncols = cut->ncols;
+	int nrows = 0;
+	int depth = 0;
+	int round = 0;
+	int ncand = 0;
+	int ncuts = 0;
+	double maxviol = 0;
+	double objval = 0;
+
+	status = CPXgetcallbacknodeinfo (env, cbdata, wherefrom, 0, CPX_CALLBACK_INFO_NODE_DEPTH, &depth);
+	if (status) goto TERMINATE;
+	if (depth == 0){
+		round = ++npass;
+		if (round > cut->maxpass) goto TERMINATE;
+	} else {
+		// a single round per tree node
+		int seqnum = 0;
+		if (!cut->tree) goto TERMINATE;
+		status = CPXgetcallbacknodeinfo (env, cbdata, wherefrom, 0, CPX_CALLBACK_INFO_NODE_SEQNUM, &seqnum);
+		if (status) goto TERMINATE;
+		if (seqnum == ts->lastcutnode) goto TERMINATE;
+		ts->lastcutnode = seqnum;
+	}
+
+	if (cut->loglevel>=3) logmsg(ts->log, LOG_SCREEN, "cutcallback called, depth %d.\n",depth);
+
+	status = CPXgetcallbacknodelp (env, cbdata, wherefrom, &nodelp);
+	if (status) goto TERMINATE;
+	nrows = CPXgetnumrows (env, nodelp);
+
+	status = reservecutscratch (cs, ncols, nrows);
+	if (status) goto TERMINATE;
+
+	status = CPXgetcallbacknodex (env, cbdata, wherefrom, cs->x, 0, ncols-1);
+	if (status) goto TERMINATE;
+	status = CPXgetcallbacknodeobjval (env, cbdata, wherefrom, &objval);
+	if (status) goto TERMINATE;
+	status = CPXgetlb (env, nodelp, cs->lb, 0, ncols-1);
+	if (status) goto TERMINATE;
+	status = CPXgetub (env, nodelp, cs->ub, 0, ncols-1);
+	if (status) goto TERMINATE;
+	status = CPXgetbase (env, nodelp, cs->cstat, cs->rstat);
+	if (status) goto TERMINATE;
+	status = CPXgetbhead (env, nodelp, cs->head, NULL);
+	if (status) goto TERMINATE;
+	status = CPXgetrhs (env, nodelp, cs->rhs, 0, nrows-1);
+	if (status) goto TERMINATE;
+	status = CPXgetsense (env, nodelp, cs->sense, 0, nrows-1);
+	if (status) goto TERMINATE;
+
+	// aging scans the whole pool under its lock, so only at the root
+	if (depth == 0) agepoolcuts (cut->pool, cs->x);
+
+	// candidates: basic hole variables that are fractional or in a hole,
+	// the ones sitting deepest inside their disjunction first
+	for (int p=0; p<nrows; p++){
+		int j = cs->head[p];
+		double pi0, pi1;
+		if (j < 0 || holes->colvar[j] < 0) continue;
+		if (!widesplit(holes, holes->colvar[j], cs->x[j], cut->ctype[j] != CPX_CONTINUOUS, &pi0, &pi1)) continue;
+		cs->candscore[p] = XMIN(cs->x[j]-pi0, pi1-cs->x[j])/(pi1-pi0);
+		cs->cand[ncand++] = p;
+	}
+	if (ncand > MAXWSCUTS){
+		const double *score = cs->candscore;
+		std::partial_sort(cs->cand, cs->cand+MAXWSCUTS, cs->cand+ncand,
+		                  [score](int a, int b){ return score[a] > score[b]; });
+		ncand = MAXWSCUTS;
+	}
+
+	for (int c=0; c<ncand; c++){
+		int p = cs->cand[c];
+		int j = cs->head[p];
+		int nz = 0;
+		double pi0, pi1, rhs, viol;
+		bool local = false;
+		widesplit(holes, holes->colvar[j], cs->x[j], cut->ctype[j] != CPX_CONTINUOUS, &pi0, &pi1);
+		status = widesplitcut (env, nodelp, cut, cs, nrows, p, cs->x[j], pi0, pi1, &nz, &rhs, &viol, &local);
+		if (status) goto TERMINATE;
+		if (nz == 0) continue;
+		if (local)
+			status = CPXcutcallbackaddlocal (env, cbdata, wherefrom, nz, rhs, 'G', cs->cutind, cs->cutval);
+		else if (addpoolcut (cut->pool, nz, cs->cutind, cs->cutval, rhs, cs->x))
+			status = CPXcutcallbackadd (env, cbdata, wherefrom, nz, rhs, 'G', cs->cutind, cs->cutval, cut->filter);
+		else
+			continue;
+		if (status) goto TERMINATE;
+		ncuts++;
+		maxviol = XMAX(maxviol, viol);
+	}
+
+	ts->cuts_tot += ncuts;
+	if (ncuts > 0) *useraction_p = CPX_CALLBACK_SET;
+
+	if (depth == 0){
+		double delta = (round > 1) ? objval - cut->lastbound : 0.0;
+		logmsg(ts->log, LOG_FILE, "round %3d: cuts %4d, maxviol %.4e, bound %.6lf (%+.6lf)\n",
+			round,ncuts,maxviol,objval,delta);
+		if (cut->loglevel>=1) logmsg(ts->log, LOG_SCREEN, "wide split round %d: %d cuts, maxviol %.4e, bound %.6lf (%+.6lf)\n",
+			round,ncuts,maxviol,objval,delta);
+		cut->lastbound = objval;
+	} else if (cut->loglevel>=2 && ncuts > 0){
+		logmsg(ts->log, LOG_SCREEN, "wide split cuts at depth %d: %d, maxviol %.4e\n",depth,ncuts,maxviol);
+	}
 
 TERMINATE:
 
@@ -448,6 +1868,189 @@ int CPXPUBLIC
 	return 0;
 }
 
+/* Repair heuristic: rounds the node LP solution, moves every variable
+ * that lies in a hole to the nearer hole edge inside its global bounds
+ * and solves the working LP with all integer and hole variables fixed
+ * for the remaining continuous variables. A feasible result is handed
+ * to cplex, which checks it against the incumbent callback again. */
+int CPXPUBLIC
+ hole_heuristiccallback (CPXCENVptr env,
+           void *cbdata,
+           int wherefrom,
+           void *cbhandle,
+           double *objval_p,
+           double *x,
+           int *checkfeas_p,
+           int *useraction_p){
+
+	*useraction_p = CPX_CALLBACK_DEFAULT;
+
+	heurdata *heur = (heurdata*) cbhandle;
+	const holeindex *holes = heur->holes;
+	threadstate *ts = getthreadstate(env, cbdata, wherefrom, heur->ts, heur->nthreads);
+	if (ts == NULL) return ERR_BADARGUMENT;
+	cbpublisher publish(ts);
+	CBTIME(ts->latheur);
+	lpworker *w = &ts->lpw;
+	int n = heur->ncols;
+	int seqnum = 0;
+	int nmoved = 0;
+	double incobj = 0;
+	double objval = 0;
+
+	int status = CPXgetcallbacknodeinfo (env, cbdata, wherefrom, 0, CPX_CALLBACK_INFO_NODE_SEQNUM, &seqnum);
+	if (status || seqnum % heur->freq != 0) return status;
+
+	// fixings: rounded integer values, hole values moved to the nearer edge
+	for (int j=0; j<n; j++){
+		double v = x[j];
+		bool fix = (heur->ctype[j] == 'B' || heur->ctype[j] == 'I');
+		if (fix) v = XMAX(heur->glb[j], XMIN(heur->gub[j], floor(v+0.5)));
+		int i = holes->colvar[j];
+		if (i >= 0){
+			int h = findhole(holes, i, v, EPSVIOL);
+			if (h >= 0){
+				double down = holes->lb[h]-1;
+				double up = holes->ub[h]+1;
+				bool godown = (x[j]-down <= up-x[j]);
+				if (godown && down < heur->glb[j]) godown = false;
+				if (!godown && up > heur->gub[j]) godown = true;
+				v = godown ? down : up;
+				if (v < heur->glb[j] || v > heur->gub[j]) return 0;
+				nmoved++;
+			}
+			fix = true;
+		}
+		w->bd[j] = fix ? v : heur->glb[j];
+		w->bd[n+j] = fix ? v : heur->gub[j];
+	}
+	// hole-free roundings are left to cplex's own heuristics
+	if (nmoved == 0) return 0;
+	ts->heurcalls++;
+
+	status = CPXchgbds (w->env, w->lp, 2*n, w->ind, w->lu, w->bd);
+	if (status) return status;
+	CPXsetintparam (w->env, CPX_PARAM_ITLIM, 2100000000);
+	status = CPXdualopt (w->env, w->lp);
+	if (status) return status;
+	if (CPXgetstat(w->env, w->lp) != CPX_STAT_OPTIMAL) return 0;
+	status = CPXgetx (w->env, w->lp, x, 0, n-1);
+	if (status) return status;
+	status = CPXgetobjval (w->env, w->lp, &objval);
+	if (status) return status;
+
+	ts->heurfound++;
+	if (CPXgetcallbackinfo(env, cbdata, wherefrom, CPX_CALLBACK_INFO_BEST_INTEGER, &incobj) == 0 &&
+	    heur->objsen*(objval - incobj) < -EPSRHS) ts->heurimproved++;
+	if (heur->loglevel>=2) logmsg(ts->log, LOG_SCREEN, "repair heuristic: %d variables moved out of holes, objective %.6lf\n", nmoved, objval);
+
+	*objval_p = objval;
+	*checkfeas_p = 1;
+	*useraction_p = CPX_CALLBACK_SET;
+	return 0;
+}
+
+int CPXPUBLIC
+ hole_deletenodecallback (CPXCENVptr env,
+           int wherefrom,
+           void *cbhandle,
+           int seqnum,
+           void *handle){
+
+	free(handle);
+	return 0;
+}
+
+struct infodata {
+
+   infodata() :		tel(NULL),
+			ts(NULL),
+			nthreads(1){}
+
+   telemetry *tel;
+   threadstate *ts;
+   int nthreads;
+};
+
+/* Writes a telemetry snapshot with the progress of the tree search and
+ * the hole counters. The counters are read from the published mirrors
+ * of the threads, which lag behind by the callbacks still running. */
+static void
+writesnapshot (telemetry *tel,
+           const threadstate *ts,
+           int nthreads,
+           double nodes,
+           double nodesleft,
+           double bound,
+           double incumbent,
+           bool done){
+
+	double inccalled = 0, increjected = 0, brstr = 0, brchange = 0, cuts = 0;
+	double incns = 0, brns = 0, cutns = 0, heurns = 0;
+	for (int t=0; t<nthreads; t++){
+		const pubcounters *pub = ts[t].pub;
+		if (pub == NULL) continue;
+		inccalled += pub->inccalled.load(std::memory_order_relaxed);
+		increjected += pub->increjected.load(std::memory_order_relaxed);
+		brstr += pub->brstr.load(std::memory_order_relaxed);
+		brchange += pub->brchange.load(std::memory_order_relaxed);
+		cuts += pub->cuts_tot.load(std::memory_order_relaxed);
+		incns += pub->incns.load(std::memory_order_relaxed);
+		brns += pub->brns.load(std::memory_order_relaxed);
+		cutns += pub->cutns.load(std::memory_order_relaxed);
+		heurns += pub->heurns.load(std::memory_order_relaxed);
+	}
+	double gap = std::isnan(incumbent) ? NAN : XABS(incumbent - bound)/(1e-10 + XABS(incumbent));
+	telemetrymetric m[] = {
+		{"bah_nodes", "Branch-and-bound nodes processed.", "counter", NULL, nodes},
+		{"bah_nodes_left", "Open branch-and-bound nodes.", "gauge", NULL, nodesleft},
+		{"bah_best_bound", "Best objective bound.", "gauge", NULL, bound},
+		{"bah_incumbent", "Objective of the incumbent, NaN without one.", "gauge", NULL, incumbent},
+		{"bah_gap", "Relative gap between incumbent and bound.", "gauge", NULL, gap},
+		{"bah_incumbents_called", "Integer solutions checked against the holes.", "counter", NULL, inccalled},
+		{"bah_incumbents_rejected", "Integer solutions rejected in a hole.", "counter", NULL, increjected},
+		{"bah_branch_strengthenings", "Branching bounds moved out of a hole.", "counter", NULL, brstr},
+		{"bah_branch_changes", "Branchings replaced by a hole branching.", "counter", NULL, brchange},
+		{"bah_cuts", "Wide split cuts added.", "counter", NULL, cuts},
+#ifdef CBTIMING
+		{"bah_callback_seconds", "Time spent in the hole callbacks.", "counter", "callback=\"incumbent\"", incns*1e-09},
+		{"bah_callback_seconds", "Time spent in the hole callbacks.", "counter", "callback=\"branch\"", brns*1e-09},
+		{"bah_callback_seconds", "Time spent in the hole callbacks.", "counter", "callback=\"cut\"", cutns*1e-09},
+		{"bah_callback_seconds", "Time spent in the hole callbacks.", "counter", "callback=\"heuristic\"", heurns*1e-09},
+		{"bah_callback_share", "Share of the thread time spent in the hole callbacks.", "gauge", NULL,
+		 (incns+brns+cutns+heurns)*1e-09/
+		 XMAX(1e-09, std::chrono::duration<double>(std::chrono::steady_clock::now() - tel->start).count()*nthreads)},
+#endif
+		{"bah_done", "1 once the search has ended.", "gauge", NULL, done ? 1.0 : 0.0},
+	};
+	writetelemetry(tel, m, (int)(sizeof(m)/sizeof(m[0])));
+}
+
+/* Writes a telemetry snapshot when one is due. */
+int CPXPUBLIC
+ hole_infocallback (CPXCENVptr env,
+           void *cbdata,
+           int wherefrom,
+           void *cbhandle){
+
+	infodata *info = (infodata*) cbhandle;
+
+	if (!telemetrydue(info->tel)) return 0;
+
+	int nodes = 0;
+	int nodesleft = 0;
+	int feas = 0;
+	double bound = 0;
+	double incumbent = NAN;
+	CPXgetcallbackinfo(env, cbdata, wherefrom, CPX_CALLBACK_INFO_NODE_COUNT, &nodes);
+	CPXgetcallbackinfo(env, cbdata, wherefrom, CPX_CALLBACK_INFO_NODES_LEFT, &nodesleft);
+	CPXgetcallbackinfo(env, cbdata, wherefrom, CPX_CALLBACK_INFO_BEST_REMAINING, &bound);
+	if (!CPXgetcallbackinfo(env, cbdata, wherefrom, CPX_CALLBACK_INFO_MIP_FEAS, &feas) && feas)
+		CPXgetcallbackinfo(env, cbdata, wherefrom, CPX_CALLBACK_INFO_BEST_INTEGER, &incumbent);
+	writesnapshot(info->tel, info->ts, info->nthreads, nodes, nodesleft, bound, incumbent, false);
+	return 0;
+}
+
 int CPXPUBLIC
  empty_cutcallback (CPXCENVptr env,
            void *cbdata,
@@ -457,7 +2060,463 @@ int CPXPUBLIC
 
 	return 0;
 }
-  
+
+/* Static hole presolve (reduceholes) against the column bounds of lp;
+ * bounds that it tightens are changed in lp as well. */
+static int
+reducemodelholes (CPXENVptr env,
+	CPXLPptr lp,
+	holeindex *holes,
+	holereduction *red){
+
+	int status = 0;
+	int ncols = CPXgetnumcols(env, lp);
+	int cnt = 0;
+	double *lb = (double*)malloc((ncols+1)*sizeof(double));
+	double *ub = (double*)malloc((ncols+1)*sizeof(double));
+	double *olb = (double*)malloc((ncols+1)*sizeof(double));
+	double *oub = (double*)malloc((ncols+1)*sizeof(double));
+	int *ind = (int*)malloc((2*ncols+1)*sizeof(int));
+	char *lu = (char*)malloc((2*ncols+1)*sizeof(char));
+	double *bd = (double*)malloc((2*ncols+1)*sizeof(double));
+
+	if ( lb == NULL || ub == NULL || olb == NULL || oub == NULL ||
+	     ind == NULL || lu == NULL || bd == NULL ) {
+		status = ERR_NOMEMORY;
+		goto TERMINATE;
+	}
+	if ( ncols > 0 ) {
+		status = CPXgetlb (env, lp, lb, 0, ncols-1);
+		if ( status ) goto TERMINATE;
+		status = CPXgetub (env, lp, ub, 0, ncols-1);
+		if ( status ) goto TERMINATE;
+	}
+	memcpy (olb, lb, ncols*sizeof(double));
+	memcpy (oub, ub, ncols*sizeof(double));
+
+	status = reduceholes (holes, lb, ub, red);
+	if ( status ) goto TERMINATE;
+
+	for (int j=0; j<ncols; j++){
+		if (lb[j] > olb[j]) ind[cnt] = j, lu[cnt] = 'L', bd[cnt++] = lb[j];
+		if (ub[j] < oub[j]) ind[cnt] = j, lu[cnt] = 'U', bd[cnt++] = ub[j];
+	}
+	if ( cnt > 0 ) status = CPXchgbds (env, lp, cnt, ind, lu, bd);
+
+TERMINATE:
+
+	FREEN (&lb);
+	FREEN (&ub);
+	FREEN (&olb);
+	FREEN (&oub);
+	FREEN (&ind);
+	FREEN (&lu);
+	FREEN (&bd);
+
+	return status;
+}
+
+/* Statistics of probeholes. */
+struct probestats {
+
+   probestats() :	lps(0),
+			infeasible(0),
+			cutoff(0),
+			tightened(0),
+			holesbefore(0),
+			holesafter(0),
+			time(0){}
+
+   int lps;
+   int infeasible;    /* segments removed as infeasible */
+   int cutoff;        /* segments removed by the cutoff */
+   int tightened;     /* bounds tightened by removed outer segments */
+   int holesbefore;
+   int holesafter;
+   double time;
+};
+
+/* Root probing: the LP relaxation of lp is solved with each hole
+ * variable restricted to each of its hole-free segments, with at most
+ * itlim iterations per LP and timelimit seconds in total. Segments
+ * that are infeasible or whose bound is worse than cutoff (from an
+ * optimal or dual feasible LP only) are removed:
+ * inner ones by widening the hole below them, outer ones by tightening
+ * the bounds, also in lp. The holes are presolved again afterwards. */
+static int
+probeholes (CPXENVptr env,
+	CPXLPptr lp,
+	holeindex *holes,
+	double cutoff,
+	double timelimit,
+	int itlim,
+	probestats *st){
+
+	int status = 0;
+	int ncols = CPXgetnumcols(env, lp);
+	int nrows = CPXgetnumrows(env, lp);
+	int objsen = CPXgetobjsen(env, lp);
+	int nzcnt = 0;
+	int surplus = 0;
+	int maxseg = 1;
+	double starttime = 0;
+	double now = 0;
+	int *rmatbeg = NULL;
+	int *rmatind = NULL;
+	double *rmatval = NULL;
+	double *lb = NULL;
+	double *ub = NULL;
+	double *segl = NULL;
+	double *segu = NULL;
+	bool *keep = NULL;
+	bool timeout = false;
+	lpworker w;
+	holereduction red;
+
+	CPXgettime(env, &starttime);
+	st->holesbefore = holes->nholes;
+
+	for (int i=0; i<holes->nvars; i++) maxseg = XMAX(maxseg, holes->beg[i+1]-holes->beg[i]+1);
+	rmatbeg = (int*)malloc((nrows+1)*sizeof(int));
+	lb = (double*)malloc((ncols+1)*sizeof(double));
+	ub = (double*)malloc((ncols+1)*sizeof(double));
+	segl = (double*)malloc(maxseg*sizeof(double));
+	segu = (double*)malloc(maxseg*sizeof(double));
+	keep = (bool*)malloc(maxseg*sizeof(bool));
+	if ( rmatbeg == NULL || lb == NULL || ub == NULL || segl == NULL || segu == NULL || keep == NULL ) {
+		status = ERR_NOMEMORY;
+		goto TERMINATE;
+	}
+	status = CPXgetrows (env, lp, &nzcnt, rmatbeg, NULL, NULL, 0, &surplus, 0, nrows-1);
+	if ( status != CPXERR_NEGATIVE_SURPLUS && status != 0 ) goto TERMINATE;
+	rmatind = (int*)malloc((-surplus+1)*sizeof(int));
+	rmatval = (double*)malloc((-surplus+1)*sizeof(double));
+	if ( rmatind == NULL || rmatval == NULL ) {
+		status = ERR_NOMEMORY;
+		goto TERMINATE;
+	}
+	status = CPXgetrows (env, lp, &nzcnt, rmatbeg, rmatind, rmatval, -surplus, &surplus, 0, nrows-1);
+	if ( status ) goto TERMINATE;
+	rmatbeg[nrows] = nzcnt;
+	status = CPXgetlb (env, lp, lb, 0, ncols-1);
+	if ( status ) goto TERMINATE;
+	status = CPXgetub (env, lp, ub, 0, ncols-1);
+	if ( status ) goto TERMINATE;
+
+	status = createlpworker (&w, env, lp, nrows, rmatbeg, rmatind, rmatval, lb, ub, itlim);
+	if ( status ) goto TERMINATE;
+	// the relaxation itself, solved to optimality for the warm starts
+	status = CPXdualopt (w.env, w.lp);
+	if ( status || CPXgetstat(w.env, w.lp) != CPX_STAT_OPTIMAL ) goto TERMINATE;
+	CPXsetintparam (w.env, CPX_PARAM_ITLIM, itlim);
+
+	for (int i=0; i<holes->nvars && !timeout; i++){
+		int j = holes->col[i];
+		if (j < 0) continue;
+
+		int nseg = holesegments(holes, i, lb[j], ub[j], -HUGE_VAL, maxseg, segl, segu);
+		if (nseg < 2) continue;
+		for (int p=0; p<nseg; p++){
+			char lu[2] = {'L', 'U'};
+			int ind[2] = {j, j};
+			double bd[2] = {segl[p], segu[p]};
+			double objval = 0;
+			int lpstat = 0;
+			int dfeasind = 0;
+			// the budget is checked per LP, segments left unsolved are kept
+			keep[p] = true;
+			CPXgettime(env, &now);
+			if (timeout || now - starttime > timelimit){
+				timeout = true;
+				continue;
+			}
+			status = CPXchgbds (w.env, w.lp, 2, ind, lu, bd);
+			if ( status ) goto TERMINATE;
+			status = CPXdualopt (w.env, w.lp);
+			if ( status ) goto TERMINATE;
+			st->lps++;
+			lpstat = CPXgetstat(w.env, w.lp);
+			// at the iteration limit the objective is a bound only if the basis is dual feasible
+			if (lpstat == CPX_STAT_ABORT_IT_LIM){
+				status = CPXsolninfo (w.env, w.lp, NULL, NULL, NULL, &dfeasind);
+				if ( status ) goto TERMINATE;
+			}
+			if (lpstat == CPX_STAT_INFEASIBLE){
+				keep[p] = false;
+				st->infeasible++;
+			} else if ((lpstat == CPX_STAT_OPTIMAL || (lpstat == CPX_STAT_ABORT_IT_LIM && dfeasind == 1)) &&
+				   XABS(cutoff) < 1e+75 && CPXgetobjval (w.env, w.lp, &objval) == 0 &&
+				   objsen*(objval - cutoff) > EPSRHS*XMAX(1.0, XABS(cutoff))){
+				keep[p] = false;
+				st->cutoff++;
+			}
+			bd[0] = lb[j];
+			bd[1] = ub[j];
+			status = CPXchgbds (w.env, w.lp, 2, ind, lu, bd);
+			if ( status ) goto TERMINATE;
+		}
+
+		int first = 0;
+		int last = nseg-1;
+		while (first < nseg && !keep[first]) first++;
+		if (first == nseg){
+			printf("WARNING: no segment of hole variable %s is feasible\n", holevarname(holes,i));
+			continue;
+		}
+		while (!keep[last]) last--;
+		// inner segments join the hole below them
+		for (int p=first+1; p<last; p++){
+			if (keep[p]) continue;
+			int h = findhole(holes, i, segl[p]-1, 0.0);
+			if (h >= 0) holes->ub[h] = segu[p];
+		}
+		// outer segments move the bounds
+		char lu[2] = {'L', 'U'};
+		int ind[2] = {j, j};
+		double bd[2] = {segl[first], segu[last]};
+		if (first > 0 || last < nseg-1){
+			st->tightened += (first > 0) + (last < nseg-1);
+			lb[j] = bd[0];
+			ub[j] = bd[1];
+			status = CPXchgbds (env, lp, 2, ind, lu, bd);
+			if ( status ) goto TERMINATE;
+			status = CPXchgbds (w.env, w.lp, 2, ind, lu, bd);
+			if ( status ) goto TERMINATE;
+		}
+	}
+
+	// merge the widened holes, clip the ones outside the new bounds
+	status = reducemodelholes (env, lp, holes, &red);
+
+TERMINATE:
+
+	CPXgettime(env, &now);
+	st->time = now - starttime;
+	st->holesafter = holes->nholes;
+	freelpworker (&w);
+	FREEN (&rmatbeg);
+	FREEN (&rmatind);
+	FREEN (&rmatval);
+	FREEN (&lb);
+	FREEN (&ub);
+	FREEN (&segl);
+	FREEN (&segu);
+	FREEN (&keep);
+
+	return status;
+}
+
+/* Presolves lp with the hole columns protected and maps the hole
+ * variables to the columns of the presolved problem. Holes of columns
+ * that presolve fixed or removed are dropped. If presolve fixed a hole
+ * variable to a value inside a hole, which no callback could reject
+ * any more, the presolved problem is discarded. *redlp_p is NULL if
+ * there is no reduced problem to use. */
+static int
+presolveholes (CPXENVptr env,
+	CPXLPptr lp,
+	holeindex *holes,
+	int loglevel,
+	CPXCLPptr *redlp_p,
+	int *nfixed_p,
+	int *nremoved_p){
+
+	int status = 0;
+	int ncols = CPXgetnumcols(env, lp);
+	int nprot = 0;
+	int prestat = 0;
+	int *protind = NULL;
+	int *pcstat = NULL;
+	int *redcol = NULL;
+	double *xred = NULL;
+	double *xorig = NULL;
+	int ninhole = 0;
+
+	*redlp_p = NULL;
+	*nfixed_p = 0;
+	*nremoved_p = 0;
+
+	// aggregating or substituting out a hole column would lose its holes
+	protind = (int*)malloc((holes->nvars+1)*sizeof(int));
+	if ( protind == NULL ) {
+		status = ERR_NOMEMORY;
+		goto TERMINATE;
+	}
+	for (int j=0; j<holes->ncols; j++){
+		if (holes->colvar[j] >= 0) protind[nprot++] = j;
+	}
+	status = CPXcopyprotected (env, lp, nprot, protind);
+	if ( status ) goto TERMINATE;
+
+	status = CPXpresolve (env, lp, CPX_ALG_NONE);
+	if ( status ) goto TERMINATE;
+	status = CPXgetredlp (env, lp, redlp_p);
+	if ( status || *redlp_p == NULL ) goto TERMINATE;
+
+	pcstat = (int*)malloc(ncols*sizeof(int));
+	redcol = (int*)malloc((holes->nvars+1)*sizeof(int));
+	xred = (double*)calloc(CPXgetnumcols(env, *redlp_p)+1, sizeof(double));
+	xorig = (double*)malloc((ncols+1)*sizeof(double));
+	if ( pcstat == NULL || redcol == NULL || xred == NULL || xorig == NULL ) {
+		status = ERR_NOMEMORY;
+		goto TERMINATE;
+	}
+	status = CPXgetprestat (env, lp, &prestat, pcstat, NULL, NULL, NULL);
+	if ( status ) goto TERMINATE;
+	// the values of the fixed columns, which do not depend on the reduced point
+	status = CPXuncrushx (env, lp, xorig, xred);
+	if ( status ) goto TERMINATE;
+
+	for (int i=0; i<holes->nvars; i++){
+		int j = holes->col[i];
+		redcol[i] = -1;
+		if (j < 0) continue;
+		if (pcstat[j] >= 0){
+			redcol[i] = pcstat[j];
+			continue;
+		}
+		switch (pcstat[j]){
+		case CPX_PRECOL_LOW:
+		case CPX_PRECOL_UP:
+		case CPX_PRECOL_FIX:
+			// the fixed value must not lie in a hole
+			if (findhole(holes, i, xorig[j], EPSVIOL) >= 0){
+				printf("WARNING: presolve fixed hole variable %s to %g inside a hole\n", holevarname(holes,i), xorig[j]);
+				ninhole++;
+			}
+			(*nfixed_p)++;
+			break;
+		default:
+			if (loglevel >= 1) printf("WARNING: presolve removed protected hole variable %s\n", holevarname(holes,i));
+			(*nremoved_p)++;
+		}
+	}
+	if (ninhole > 0){
+		printf("WARNING: presolve fixed %d hole variables inside a hole, solving without presolve\n", ninhole);
+		*redlp_p = NULL;
+		*nfixed_p = 0;
+		*nremoved_p = 0;
+		status = CPXfreepresolve (env, lp);
+		goto TERMINATE;
+	}
+	status = setholecols (holes, CPXgetnumcols(env, *redlp_p), redcol);
+
+TERMINATE:
+
+	FREEN (&protind);
+	FREEN (&pcstat);
+	FREEN (&redcol);
+	FREEN (&xred);
+	FREEN (&xorig);
+
+	return status;
+}
+
+/* Solves the instance with the native branch-and-bound instead of
+ * CPLEX. The holes are read, matched and presolved as for the
+ * callbacks; no CPLEX environment is opened. Prints the same summary
+ * lines as the CPLEX backend. */
+static int
+solvenative (Options &opt,
+	const std::string &FileName,
+	const std::string &hFileName,
+	const std::string &hBinName,
+	bool usebin,
+	const std::string &logFileName){
+
+	typedef std::chrono::steady_clock clock;
+
+	int status = 0;
+	FILE *fout = NULL;
+	mpsproblem prob;
+	holeindex holes;
+	holereduction holered;
+	nativeparams par;
+	nativeresult res;
+	int nunmatched = 0;
+	std::vector<const char*> colname;
+	std::string opt_stat;
+	clock::time_point start = clock::now();
+
+	if (FileName.find(".mps") == std::string::npos){
+		printf("ERROR: the native backend reads .mps files only\n");
+		return ERR_BADARGUMENT;
+	}
+	if (opt.s_opt["search"].first != "best" && opt.s_opt["search"].first != "dfs"){
+		printf("ERROR: unknown search %s\n", opt.s_opt["search"].first.c_str());
+		return ERR_BADPARAMVALUE;
+	}
+	fout = fopen (logFileName.c_str(),"a");
+	if (fout==NULL) return ERR_OPENFILE;
+
+	status = readmps (FileName.c_str(), &prob);
+	if ( status ) {
+		printf("Could not read file %s error %i\n", FileName.c_str(), status);
+		goto TERMINATE;
+	}
+	printf("native: %s, %d rows, %d columns, %d nonzeros\n", FileName.c_str(), prob.nrows, prob.ncols, prob.matbeg[prob.ncols]);
+
+	if (usebin){
+		status = readholes_bin (hBinName.c_str(),&holes);
+		if ( status ) {
+			printf("WARNING: invalid binary hole file %s, reading %s instead\n",hBinName.c_str(),hFileName.c_str());
+			usebin = false;
+		}
+	}
+	if (!usebin) status = readholes_mmap (hFileName.c_str(),&holes);
+	if ( status ) goto TERMINATE;
+
+	colname.resize(prob.ncols);
+	for (int j=0; j<prob.ncols; j++) colname[j] = prob.colname[j].c_str();
+	status = matchholecols (&holes, prob.ncols, colname.data(), &nunmatched);
+	if ( status ) goto TERMINATE;
+	if (!opt.b_opt["noholepre"].first) {
+		status = reduceholes (&holes, prob.lb.data(), prob.ub.data(), &holered);
+		if ( status ) goto TERMINATE;
+		if (holered.infeasible > 0) printf("WARNING: %d hole variables have no value outside their holes\n", holered.infeasible);
+	}
+	printf("hole setup: %d variables with %d holes, %d unmatched, %.3lf sec\n",holes.nvars,holes.nholes,nunmatched,
+	       std::chrono::duration<double>(clock::now() - start).count());
+
+	par.timelimit = opt.d_opt["bab_time"].first;
+	par.depthfirst = opt.s_opt["search"].first == "dfs";
+	par.cutoff = opt.d_opt["cutoff"].first;
+	par.loglevel = opt.i_opt["log"].first;
+
+	fprintf(fout,"\n%s, backend native, search %s, time %.2lf\n-------------------------------------------------------------------------------\n",
+		FileName.c_str(),opt.s_opt["search"].first.c_str(),opt.d_opt["bab_time"].first);
+	fprintf(fout,"hole setup: %d variables with %d holes, %d unmatched\n",holes.nvars,holes.nholes,nunmatched);
+
+	status = nativebranchandbound (&prob, &holes, &par, &res);
+	if ( status ) goto TERMINATE;
+
+	switch (res.status){
+	  case NATIVE_OPTIMAL:
+	    opt_stat = "OPTIMAL";
+	    break;
+	  case NATIVE_TIMELIMIT:
+	    opt_stat = "TIME_LIMIT";
+	    break;
+	  case NATIVE_INFEASIBLE:
+	    opt_stat = "INFEASIBLE";
+	    break;
+	  default:
+	    opt_stat = "OTHER_EXIT";
+	}
+	fprintf(fout,"native: LP iterations %ld, max open nodes %ld\n",res.lpiters,res.maxopen);
+	printf("native: LP iterations %ld, max open nodes %ld\n",res.lpiters,res.maxopen);
+	printf("\nBRANCH-AND-HOLE: nodes %li bound %.10f sol %.10f %s cuts %d incs %d/%d branch %d/%d time %.2lf\n", res.nodes, res.bound, res.objval, opt_stat.c_str(), 0, res.rejected, res.candidates, res.snapped, res.holebranch, res.time);
+	fprintf(fout,"-------------------------------\nFINAL: nodes %li bound %.10f sol %.10f %s time %.2lf\n", res.nodes, res.bound, res.objval, opt_stat.c_str(), res.time);
+
+TERMINATE:
+
+	freeholeindex (&holes);
+	if ( fout != NULL ) fclose (fout);
+	if ( status ) printf ("FINAL STATUS: %d\n", status);
+
+	return status;
+}
+
 int main(int argc, const char *argv[])
 {
   Options opt;
@@ -468,10 +2527,9 @@ int main(int argc, const char *argv[])
     opt.usage();
     exit(1);
   }
-    
-  if (opt.i_opt["n"].first > 0) {
-      std::cerr <<"WARNING: Chose to separate user cuts, but no separation is currently implemented." <<std::endl;
-  }
+  // the node propagation, multiway branching and variable selection run in the branch callback
+  if (opt.i_opt["sb"].first > 0) opt.b_opt["select"].first = true;
+  if (opt.b_opt["prop"].first || opt.b_opt["multiway"].first || opt.b_opt["select"].first) opt.b_opt["br"].first = true;
     
   int status = 0;
   CPXENVptr env = NULL;
@@ -481,6 +2539,7 @@ int main(int argc, const char *argv[])
   char *ctype = NULL;
   double objval;
   double cutoff;
+  bool hasincumbent = false;
   std::string opt_stat;
 
   int filter = opt.b_opt["filter"].first ? CPX_USECUT_FILTER : CPX_USECUT_PURGE;
@@ -512,26 +2571,77 @@ int main(int argc, const char *argv[])
   }
 
 
-  std::cout<<FileName<<", "<<hFileName<<", "<<logFileName<<std::endl;
+  // a binary hole file next to the text one is preferred if present
+  std::string hBinName (hFileName);
+  if (hFileName.size() >= 4 && hFileName.compare(hFileName.size()-4,4,".bin") == 0){
+	hFileName.replace(hFileName.size()-4,4,".txt");
+  } else if (hBinName.size() >= 4 && hBinName.compare(hBinName.size()-4,4,".txt") == 0){
+	hBinName.replace(hBinName.size()-4,4,".bin");
+  } else {
+	hBinName += ".bin";
+  }
+  bool usebin = !opt.b_opt["convert"].first && access(hBinName.c_str(), R_OK) == 0;
+  if (usebin && !holebinmatches(hBinName.c_str(), hFileName.c_str())){
+	printf("WARNING: %s was not written from the current %s, reading the text file (rerun -convert)\n",
+	       hBinName.c_str(), hFileName.c_str());
+	usebin = false;
+  }
+
+  std::cout<<FileName<<", "<<(usebin ? hBinName : hFileName)<<", "<<logFileName<<std::endl;
 
   FILE *fout = NULL;
 
-   int nvarswithholes=0;
-   double *lbvarswithholes=NULL;
-   double *ubvarswithholes=NULL;
-   int *nholesvarswithholes=NULL;
-   char **namevarswithholes=NULL;
-   double **lbholes=NULL;
-   double **ubholes=NULL;
+  if (opt.b_opt["convert"].first){
+	holeindex textholes;
+	int xstatus = readholes_mmap (hFileName.c_str(),&textholes);
+	if ( !xstatus ) xstatus = writeholes_bin (hBinName.c_str(),&textholes,hFileName.c_str());
+	if ( !xstatus ) printf("converted %s to %s: %d variables, %d holes\n",
+	                       hFileName.c_str(),hBinName.c_str(),textholes.nvars,textholes.nholes);
+	else printf("Could not convert %s to %s, error %i\n",hFileName.c_str(),hBinName.c_str(),xstatus);
+	freeholeindex (&textholes);
+	return xstatus;
+  }
+
+  if (opt.s_opt["backend"].first == "native"){
+	return solvenative (opt, FileName, hFileName, hBinName, usebin, logFileName);
+  } else if (opt.s_opt["backend"].first != "cplex"){
+	printf("ERROR: unknown backend %s\n", opt.s_opt["backend"].first.c_str());
+	return ERR_BADPARAMVALUE;
+  }
+
    int ncols = 0;
-   std::map<std::string, int> name_to_index;
-   std::map<int, std::string> index_to_name;
-   std::map<int, int> index_to_index;
+   char **colname = NULL;
+   char *colnamestore = NULL;
+   int nunmatched = 0;
+   double starttime = 0;
+   double setuptime = 0;
+   double solvetime = 0;
    bool *has_hole = NULL;
+   int *rmatbeg = NULL;
+   int *rmatind = NULL;
+   double *rmatval = NULL;
+   double *glb = NULL;
+   double *gub = NULL;
+   holeindex holes;
+   holereduction holered;
+   probestats probe;
+   cutpool pool;
+   pseudocost pc;
+   int nthreads = 1;
+   threadstate *ts = NULL;
+   pubcounters *pub = NULL;
+   threadstate total;
+   asynclog alog;
+   telemetry tel;
+   CPXCLPptr cblp = NULL;
+   int nprefixed = 0;
+   int npreremoved = 0;
 
   incumbentdata inc;
+  infodata info;
   branchdata branch;
   cutdata cut;
+  heurdata heur;
 
   env = CPXopenCPLEX(&status); 
   if (status) goto TERMINATE;
@@ -554,15 +2664,24 @@ int main(int argc, const char *argv[])
   // turn off nonlinear and dual reductions (should be implied by presence of incumbentcallback)
   CPXsetintparam(env, CPX_PARAM_PRELINEAR, CPX_OFF);
   CPXsetintparam(env, CPX_PARAM_REDUCE, CPX_PREREDUCE_PRIMALONLY);
-  // also turn off primal reductions because we use the function CPXgetcallbacknodelp
-  CPXsetintparam(env, CPXPARAM_Preprocessing_Presolve, CPX_OFF);
-  // let callback ork on original problems
-  CPXsetintparam(env, CPX_PARAM_MIPCBREDLP, CPX_OFF);
+  if (opt.b_opt["presolve"].first){
+	// keep primal reductions, the callbacks work on the presolved problem
+	CPXsetintparam(env, CPX_PARAM_MIPCBREDLP, CPX_ON);
+  } else {
+	// also turn off primal reductions because we use the function CPXgetcallbacknodelp
+	CPXsetintparam(env, CPXPARAM_Preprocessing_Presolve, CPX_OFF);
+	// let callback ork on original problems
+	CPXsetintparam(env, CPX_PARAM_MIPCBREDLP, CPX_OFF);
+  }
 
   CPXsetdblparam(env, CPX_PARAM_EPGAP, 1e-08);
   CPXsetdblparam(env, CPX_PARAM_EPAGAP, 1e-08);
-  CPXsetintparam(env, CPX_PARAM_THREADS, 1);
+  CPXsetintparam(env, CPX_PARAM_THREADS, opt.i_opt["threads"].first);
   CPXsetdblparam(env, CPX_PARAM_TILIM, opt.d_opt["bab_time"].first);
+  if (opt.i_opt["seed"].first >= 0) CPXsetintparam(env, CPX_PARAM_RANDOMSEED, opt.i_opt["seed"].first);
+  if (XABS(opt.d_opt["cutoff"].first) < 1e+75){
+	CPXsetdblparam(env, CPXgetobjsen(env, lp) == CPX_MIN ? CPX_PARAM_CUTUP : CPX_PARAM_CUTLO, opt.d_opt["cutoff"].first);
+  }
 
   if (opt.b_opt["c"].first){
 	CPXsetintparam(env, CPXPARAM_MIP_Cuts_LiftProj, -1);
@@ -570,6 +2689,7 @@ int main(int argc, const char *argv[])
 	CPXsetintparam(env, CPXPARAM_MIP_Limits_EachCutLimit, 0);
   }
 
+  cblp = lp;
   ncols = CPXgetnumcols(env, lp);
   norigrows = CPXgetnumrows(env, lp);
 
@@ -579,37 +2699,99 @@ int main(int argc, const char *argv[])
       status = ERR_NOMEMORY;
       goto TERMINATE;
    }
+  for (int j=0; j<ncols; j++) has_hole[j] = FALSE;
     
-  if (opt.b_opt["inc"].first || opt.b_opt["bra"].first || opt.i_opt["n"].first > 0) {
-	status = readholes (hFileName.c_str(),&nvarswithholes,&lbvarswithholes,
-                           &ubvarswithholes,&nholesvarswithholes,
-                           &namevarswithholes,&lbholes,&ubholes);
-  if ( status ) goto TERMINATE;
+  if (opt.b_opt["inc"].first || opt.b_opt["br"].first || opt.i_opt["n"].first > 0 || opt.i_opt["repair"].first > 0 || opt.b_opt["probe"].first) {
+	CPXgettime(env, &starttime);
+	// read the hole information into one contiguous index
+	if (usebin){
+		status = readholes_bin (hBinName.c_str(),&holes);
+		if ( status ) {
+			printf("WARNING: invalid binary hole file %s, reading %s instead\n",hBinName.c_str(),hFileName.c_str());
+			usebin = false;
+		}
+	}
+	if (!usebin) status = readholes_mmap (hFileName.c_str(),&holes);
+	if ( status ) goto TERMINATE;
       
-    // map variable names to column indices and vice versa
-	char* name[1] = {NULL};
-	char* namestore = NULL;
-	namestore = (char*)malloc(BUFFERSIZE*sizeof(char));
-	if ( namestore == NULL) {
+	// map variable names to column indices: fetch all column names
+	// with a single call and match them through a hash index
+	int surplus = 0;
+	status = CPXgetcolname (env, lp, NULL, NULL, 0, &surplus, 0, ncols-1);
+	if ( status != CPXERR_NEGATIVE_SURPLUS ) {
+		if ( status == 0 ) status = ERR_BADPROBLEM;
+		printf("Could not get column names of %s, error %i\n", FileName.c_str(), status);
+		goto TERMINATE;
+	}
+	colname = (char**)malloc(ncols*sizeof(char*));
+	colnamestore = (char*)malloc(-surplus*sizeof(char));
+	if ( colname == NULL || colnamestore == NULL ) {
             status = ERR_NOMEMORY;
             goto TERMINATE;
         }
-	int surplus = 0;
+	status = CPXgetcolname (env, lp, colname, colnamestore, -surplus, &surplus, 0, ncols-1);
+	if ( status ) goto TERMINATE;
+
+	status = matchholecols (&holes, ncols, colname, &nunmatched);
+	if ( status ) goto TERMINATE;
+	FREEN (&colname);
+	FREEN (&colnamestore);
+
+	if (!opt.b_opt["noholepre"].first) {
+		status = reducemodelholes (env, lp, &holes, &holered);
+		if ( status ) goto TERMINATE;
+		if (holered.infeasible > 0) printf("WARNING: %d hole variables have no value outside their holes\n", holered.infeasible);
+	}
+
+	for (int i=0; i<holes.nvars; i++){
+		if (holes.col[i] >= 0) has_hole[holes.col[i]] = TRUE;
+		else if (opt.i_opt["log"].first>=1) printf("WARNING: hole variable %s not found in %s\n", holevarname(&holes,i), FileName.c_str());
+	}
+	CPXgettime(env, &setuptime);
+	setuptime -= starttime;
+	printf("hole setup: %d variables with %d holes, %d unmatched, %.3lf sec\n",holes.nvars,holes.nholes,nunmatched,setuptime);
+	if (!opt.b_opt["noholepre"].first)
+		printf("hole presolve: %d holes merged, %d removed, %d bounds tightened, %d variables dropped, %d bound mismatches\n",
+		       holered.merged,holered.clipped,holered.tightened,holered.dropped,holered.bounddiff);
+  }
+
+  // root probing on the hole-free segments
+  if (opt.b_opt["probe"].first && holes.nvars > 0) {
+	status = probeholes (env, lp, &holes, opt.d_opt["cutoff"].first, opt.d_opt["probetime"].first,
+	                     opt.i_opt["probeiter"].first, &probe);
+	if ( status ) goto TERMINATE;
 	for (int j=0; j<ncols; j++) has_hole[j] = FALSE;
-	for (int i=0; i<nvarswithholes; i++){
-		for (int j=0; j<ncols; j++){
-			status = CPXgetcolname (env, lp, name, namestore, BUFFERSIZE, &surplus, j, j);
-			if ( status ) goto TERMINATE;
-			if (!strcmp(namestore,namevarswithholes[i])){
-				name_to_index[namestore] = j;
-				index_to_name[j] = namestore;
-				index_to_index[j] = i;
-				has_hole[j] = TRUE;
-				break;
-			}
+	for (int i=0; i<holes.nvars; i++){
+		if (holes.col[i] >= 0) has_hole[holes.col[i]] = TRUE;
+	}
+	printf("probing: %d LPs, segments removed %d infeasible %d by cutoff, %d bounds tightened, holes %d -> %d, %.2lf sec\n",
+	       probe.lps,probe.infeasible,probe.cutoff,probe.tightened,probe.holesbefore,probe.holesafter,probe.time);
+  }
+
+  // presolve once with the hole columns protected; from here on the
+  // holes, the callbacks and the data they use refer to the presolved problem
+  if (opt.b_opt["presolve"].first && holes.nvars > 0) {
+	CPXCLPptr redlp = NULL;
+	status = presolveholes (env, lp, &holes, opt.i_opt["log"].first, &redlp, &nprefixed, &npreremoved);
+	if ( status ) goto TERMINATE;
+	if (redlp != NULL) {
+		cblp = redlp;
+		ncols = CPXgetnumcols(env, cblp);
+		norigrows = CPXgetnumrows(env, cblp);
+		FREEN (&has_hole);
+		has_hole = (bool*)malloc((ncols+1)*sizeof(bool));
+		if ( has_hole == NULL ) {
+			status = ERR_NOMEMORY;
+			goto TERMINATE;
 		}
+		for (int j=0; j<ncols; j++) has_hole[j] = (holes.colvar[j] >= 0);
+		printf("cplex presolve: reduced problem %d columns, %d rows, %d hole variables fixed, %d removed\n",
+		       ncols,norigrows,nprefixed,npreremoved);
+	} else {
+		printf("WARNING: no reduced problem to use, holes stay on the original problem\n");
+		CPXsetintparam(env, CPX_PARAM_MIPCBREDLP, CPX_OFF);
+		CPXsetintparam(env, CPXPARAM_Preprocessing_Presolve, CPX_OFF);
 	}
-	FREEN(&namestore);
   }
 
   // get ctype information
@@ -618,48 +2800,129 @@ int main(int argc, const char *argv[])
       status = ERR_NOMEMORY;
       goto TERMINATE;
    }
-   status = CPXgetctype (env, lp, ctype, 0, ncols-1);
+   status = CPXgetctype (env, cblp, ctype, 0, ncols-1);
    if ( status ) goto TERMINATE;
 
-   inc.nvarswithholes=nvarswithholes;
-   inc.lbvarswithholes=lbvarswithholes;
-   inc.ubvarswithholes=ubvarswithholes;
-   inc.nholesvarswithholes=nholesvarswithholes;
-   inc.namevarswithholes=namevarswithholes;
-   inc.lbholes=lbholes;
-   inc.ubholes=ubholes;
-   inc.name_to_index=name_to_index;
+  // original rows and global bounds for the wide split cuts, the strong branching and the repair heuristic
+  if (opt.i_opt["n"].first > 0 || opt.i_opt["sb"].first > 0 || opt.i_opt["repair"].first > 0) {
+	int nzcnt = 0;
+	int surplus = 0;
+	rmatbeg = (int*)malloc((norigrows+1)*sizeof(int));
+	glb = (double*)malloc(ncols*sizeof(double));
+	gub = (double*)malloc(ncols*sizeof(double));
+	if ( rmatbeg == NULL || glb == NULL || gub == NULL ) {
+		status = ERR_NOMEMORY;
+		goto TERMINATE;
+	}
+	status = CPXgetrows (env, cblp, &nzcnt, rmatbeg, NULL, NULL, 0, &surplus, 0, norigrows-1);
+	if ( status != CPXERR_NEGATIVE_SURPLUS && status != 0 ) goto TERMINATE;
+	rmatind = (int*)malloc((-surplus+1)*sizeof(int));
+	rmatval = (double*)malloc((-surplus+1)*sizeof(double));
+	if ( rmatind == NULL || rmatval == NULL ) {
+		status = ERR_NOMEMORY;
+		goto TERMINATE;
+	}
+	status = CPXgetrows (env, cblp, &nzcnt, rmatbeg, rmatind, rmatval, -surplus, &surplus, 0, norigrows-1);
+	if ( status ) goto TERMINATE;
+	rmatbeg[norigrows] = nzcnt;
+	status = CPXgetlb (env, cblp, glb, 0, ncols-1);
+	if ( status ) goto TERMINATE;
+	status = CPXgetub (env, cblp, gub, 0, ncols-1);
+	if ( status ) goto TERMINATE;
+  }
+
+   // one callback state per thread
+   nthreads = opt.i_opt["threads"].first;
+   if (nthreads <= 0) {
+      status = CPXgetnumcores (env, &nthreads);
+      if ( status ) goto TERMINATE;
+   }
+   branch.prop=opt.b_opt["prop"].first;
+   branch.multiway=opt.b_opt["multiway"].first;
+   branch.maxchildren=XMAX(opt.i_opt["maxchildren"].first, 2);
+   if (opt.b_opt["br"].first) {
+      initpseudocost (&pc, holes.nvars);
+      branch.pc=&pc;
+   }
+   branch.select=opt.b_opt["select"].first;
+   branch.estlog=opt.b_opt["estlog"].first;
+   branch.objsen=CPXgetobjsen(env, cblp);
+   branch.sbcand=XMAX(opt.i_opt["sb"].first, 0);
+   branch.sbdepth=opt.i_opt["sbdepth"].first;
+   branch.sbbudget=opt.d_opt["sbtime"].first;
+   ts = new threadstate[nthreads];
+   pub = new pubcounters[nthreads];
+   for (int t=0; t<nthreads; t++){
+      ts[t].pub = &pub[t];
+      // scratch for the branch callback, sized for a two-way variable
+      // branching; grown by the callback to the largest branching seen
+      status = reservescratch (&ts[t], 2, 2);
+      if ( status ) goto TERMINATE;
+      if (opt.b_opt["prop"].first || opt.b_opt["select"].first) {
+         status = reservepropscratch (&ts[t], ncols, holes.nvars);
+         if ( status ) goto TERMINATE;
+      }
+      if (opt.b_opt["multiway"].first) {
+         status = reservesegscratch (&ts[t], branch.maxchildren);
+         if ( status ) goto TERMINATE;
+      }
+      if (opt.b_opt["select"].first) {
+         status = reservecandscratch (&ts[t], XMAX(branch.sbcand, 1));
+         if ( status ) goto TERMINATE;
+      }
+      if (branch.sbcand > 0 || opt.i_opt["repair"].first > 0) {
+         status = createlpworker (&ts[t].lpw, env, cblp, norigrows, rmatbeg, rmatind, rmatval, glb, gub, opt.i_opt["sbiter"].first);
+         if ( status ) goto TERMINATE;
+      }
+   }
+
+   // the callbacks log through the rings of their thread
+   status = startasynclog (&alog, nthreads, XMAX(opt.i_opt["logbuf"].first, 1), fout);
+   if ( status ) goto TERMINATE;
+   for (int t=0; t<nthreads; t++) ts[t].log = &alog.rings[t];
+
+   inc.holes=&holes;
+   inc.ts=ts;
+   inc.nthreads=nthreads;
    inc.ncols=ncols;
    inc.loglevel=opt.i_opt["log"].first;
 
-   branch.nvarswithholes=nvarswithholes;
-   branch.lbvarswithholes=lbvarswithholes;
-   branch.ubvarswithholes=ubvarswithholes;
-   branch.nholesvarswithholes=nholesvarswithholes;
-   branch.namevarswithholes=namevarswithholes;
-   branch.lbholes=lbholes;
-   branch.ubholes=ubholes;
-   branch.name_to_index=name_to_index;
-   branch.index_to_name=index_to_name;
-   branch.index_to_index=index_to_index;
+   branch.holes=&holes;
    branch.ncols=ncols;
    branch.loglevel=opt.i_opt["log"].first;
    branch.has_hole=has_hole;
+   branch.ts=ts;
+   branch.nthreads=nthreads;
 
-   cut.nvarswithholes=nvarswithholes;
-   cut.lbvarswithholes=lbvarswithholes;
-   cut.ubvarswithholes=ubvarswithholes;
-   cut.nholesvarswithholes=nholesvarswithholes;
-   cut.namevarswithholes=namevarswithholes;
-   cut.lbholes=lbholes;
-   cut.ubholes=ubholes;
-   cut.name_to_index=name_to_index;
+   cut.holes=&holes;
    cut.ncols=ncols;
    cut.maxpass=opt.i_opt["n"].first;
    cut.ctype=ctype;
    cut.filter=filter;
-   cut.fout=fout;
    cut.loglevel=opt.i_opt["log"].first;
+   cut.ts=ts;
+   cut.nthreads=nthreads;
+   cut.tree=opt.b_opt["ctree"].first;
+   cut.norigrows=norigrows;
+   cut.rmatbeg=rmatbeg;
+   cut.rmatind=rmatind;
+   cut.rmatval=rmatval;
+   cut.glb=glb;
+   cut.gub=gub;
+   cut.pool=&pool;
+
+   heur.holes=&holes;
+   heur.ncols=ncols;
+   heur.ctype=ctype;
+   heur.glb=glb;
+   heur.gub=gub;
+   heur.objsen=CPXgetobjsen(env, cblp);
+   heur.freq=XMAX(opt.i_opt["repair"].first, 1);
+   heur.loglevel=opt.i_opt["log"].first;
+   heur.ts=ts;
+   heur.nthreads=nthreads;
+   pool.maxage=opt.i_opt["poolage"].first;
+   pool.maxnz=(int)XMIN(opt.d_opt["poolmem"].first*1048576.0/(sizeof(int)+sizeof(double)), 2147483647.0);
 
   if(opt.b_opt["inc"].first)
     CPXsetincumbentcallbackfunc(env, hole_incumbentcallback, &inc);
@@ -669,6 +2932,12 @@ int main(int argc, const char *argv[])
     CPXsetbranchcallbackfunc(env, hole_branchcallback, &branch);
   else
     CPXsetbranchcallbackfunc(env, empty_branchcallback, &branch);
+  if(opt.b_opt["br"].first)
+    CPXsetdeletenodecallbackfunc(env, hole_deletenodecallback, NULL);
+  if(opt.i_opt["repair"].first > 0)
+    CPXsetheuristiccallbackfunc(env, hole_heuristiccallback, &heur);
+  if(opt.stringset["telemetry"])
+    CPXsetinfocallbackfunc(env, hole_infocallback, &info);
   if(opt.i_opt["n"].first > 0)
     CPXsetusercutcallbackfunc(env, hole_cutcallback, &cut);
   else
@@ -678,16 +2947,101 @@ int main(int argc, const char *argv[])
   status = CPXsetstrparam (env, CPX_PARAM_WORKDIR, "/mnt/cluster-tmp/sven/");
   if (status) goto TERMINATE;
   // print log line
-  fprintf(fout,"\n%s, inccb %d, brcb %d, maxrounds %4d, cpxcuts off %d, filter %d, time %.2lf\n-------------------------------------------------------------------------------\n",
-	  FileName.c_str(),opt.b_opt["inc"].first,opt.b_opt["br"].first,opt.i_opt["n"].first,
-	  opt.b_opt["c"].first,opt.b_opt["filter"].first,opt.d_opt["bab_time"].first);
+  fprintf(fout,"\n%s, inccb %d, brcb %d, maxrounds %4d, treecuts %d, cpxcuts off %d, filter %d, time %.2lf, threads %d, presolve %d, prop %d, multiway %d, select %d, sb %d, repair %d, probe %d\n-------------------------------------------------------------------------------\n",
+	  FileName.c_str(),opt.b_opt["inc"].first,opt.b_opt["br"].first,opt.i_opt["n"].first,opt.b_opt["ctree"].first,
+	  opt.b_opt["c"].first,opt.b_opt["filter"].first,opt.d_opt["bab_time"].first,nthreads,opt.b_opt["presolve"].first,opt.b_opt["prop"].first,
+	  opt.b_opt["multiway"].first ? branch.maxchildren : 0,opt.b_opt["select"].first,branch.sbcand,
+	  opt.i_opt["repair"].first,opt.b_opt["probe"].first);
+  if (holes.nvars > 0) fprintf(fout,"hole setup: %d variables with %d holes, %d unmatched, %.3lf sec\n",holes.nvars,holes.nholes,nunmatched,setuptime);
+  if (holes.nvars > 0 && !opt.b_opt["noholepre"].first)
+	fprintf(fout,"hole presolve: %d holes merged, %d removed, %d bounds tightened, %d variables dropped, %d bound mismatches\n",
+		holered.merged,holered.clipped,holered.tightened,holered.dropped,holered.bounddiff);
+  if (opt.b_opt["probe"].first && holes.nvars > 0)
+	fprintf(fout,"probing: %d LPs, segments removed %d infeasible %d by cutoff, %d bounds tightened, holes %d -> %d, %.2lf sec\n",
+		probe.lps,probe.infeasible,probe.cutoff,probe.tightened,probe.holesbefore,probe.holesafter,probe.time);
+  if (cblp != lp) fprintf(fout,"cplex presolve: reduced problem %d columns, %d rows, %d hole variables fixed, %d removed\n",ncols,norigrows,nprefixed,npreremoved);
+  if (opt.stringset["telemetry"]){
+	inittelemetry(&tel, opt.s_opt["telemetry"].first, opt.d_opt["telemetry_interval"].first, FileName);
+	info.tel=&tel;
+	info.ts=ts;
+	info.nthreads=nthreads;
+	writesnapshot(&tel, ts, nthreads, 0, 0, -HUGE_VAL*CPXgetobjsen(env, lp), NAN, false);
+  }
+  CPXgettime(env, &starttime);
   CPXmipopt(env, lp); 
+  CPXgettime(env, &solvetime);
+  solvetime -= starttime;
+  stopasynclog(&alog);
+  if (alog.dropped > 0) {
+	fprintf(fout,"log messages dropped: %ld of %ld\n",alog.dropped,alog.dropped+alog.written);
+	printf("log messages dropped: %ld of %ld (raise -logbuf)\n",alog.dropped,alog.dropped+alog.written);
+  }
+  sumthreadstate(ts, nthreads, &total);
   // print log lines
-  if (opt.i_opt["n"].first>0) fprintf(fout,"... total: %d\n",cuts_tot);
-  if (opt.b_opt["inc"].first) fprintf(fout,"-------------------------------\nincumbent rejected/called: %d/%d\n",increjected,inccalled);
-  if (opt.b_opt["br"].first) fprintf(fout,"-------------------------------\nbranch strengthenings/changes: %d/%d\n",brstr,brchange);
+  if (opt.i_opt["n"].first>0) {
+	fprintf(fout,"... total: %d\n",total.cuts_tot);
+	fprintf(fout,"cut pool: %d cuts (%ld nz), %d tombstones, hit rate %.2lf%% of %ld lookups, duplicates rejected %ld (%ld of aged out cuts), replaced %ld, added again %ld, aged out %ld, evicted %ld\n",
+		pool.nalive,pool.nzalive,pool.ntomb,pool.lookups > 0 ? 100.0*pool.hits/pool.lookups : 0.0,pool.lookups,
+		pool.rejected,pool.tombhits,pool.replaced,pool.readded,pool.agedout,pool.evicted);
+  }
+  if (opt.b_opt["inc"].first) fprintf(fout,"-------------------------------\nincumbent rejected/called: %d/%d\n",total.increjected,total.inccalled);
+  if (opt.b_opt["br"].first) fprintf(fout,"-------------------------------\nbranch strengthenings/changes: %d/%d\n",total.brstr,total.brchange);
+  if (opt.b_opt["br"].first && total.estcnt > 0) {
+	fprintf(fout,"child estimates: %d compared, mean error %.4e (bias %+.4e), parent objective %.4e\n",total.estcnt,
+		total.esterr/total.estcnt,total.estbias/total.estcnt,total.parerr/total.estcnt);
+  }
+  if (opt.b_opt["multiway"].first) {
+	fprintf(fout,"multiway branchings %d, children %d (%.2lf per branching)\n",total.mwbranch,total.mwchildren,
+		total.mwbranch > 0 ? (double)total.mwchildren/total.mwbranch : 0.0);
+	printf("multiway branchings %d, children %d\n",total.mwbranch,total.mwchildren);
+  }
+  if (opt.b_opt["select"].first) {
+	fprintf(fout,"selection: branchings %d, cplex choice overridden %d\n",total.selbranch,total.seloverride);
+	printf("selection: branchings %d, cplex choice overridden %d\n",total.selbranch,total.seloverride);
+	printpseudocost(fout, &holes, &pc, opt.i_opt["log"].first>=2);
+	printpseudocost(stdout, &holes, &pc, false);
+  }
+  if (opt.i_opt["repair"].first > 0) {
+	fprintf(fout,"repair heuristic: calls %d, feasible %d, improved incumbent %d\n",total.heurcalls,total.heurfound,total.heurimproved);
+	printf("repair heuristic: calls %d, feasible %d, improved incumbent %d\n",total.heurcalls,total.heurfound,total.heurimproved);
+  }
+  if (branch.sbcand > 0) {
+	fprintf(fout,"strong branching: calls %d, child LPs %d, infeasible segments %d, nodes pruned %d, time %.2lf (%.1lf%% of solve)\n",
+		total.sbcalls,total.sblps,total.sbinfeas,total.sbpruned,total.sbtime,solvetime > 0 ? 100.0*total.sbtime/(solvetime*nthreads) : 0.0);
+	printf("strong branching: calls %d, child LPs %d, infeasible segments %d, time %.2lf\n",total.sbcalls,total.sblps,total.sbinfeas,total.sbtime);
+  }
+  if (opt.b_opt["prop"].first) {
+	fprintf(fout,"propagation: bounds tightened %d, nodes pruned %d\n",total.proptight,total.proppruned);
+	printf("propagation: bounds tightened %d, nodes pruned %d\n",total.proptight,total.proppruned);
+  }
+#ifdef CBTIMING
+  {
+	// share of the thread time: the solve time summed over the threads
+	double threadtime = solvetime*nthreads;
+	double cbtime = (total.latinc.totalns+total.latbr.totalns+total.latcut.totalns+total.latheur.totalns)*1e-09;
+	fprintf(fout,"-------------------------------\ncallback latency:\n{\n  \"solvetime\": %.6f,\n  \"threads\": %d,\n"
+		"  \"counters\": {\"inccalled\": %d, \"increjected\": %d, \"brstr\": %d, \"brchange\": %d},\n",
+		solvetime,nthreads,total.inccalled,total.increjected,total.brstr,total.brchange);
+	writelatencyjson(fout, "incumbent", &total.latinc, threadtime);
+	fprintf(fout,",\n");
+	writelatencyjson(fout, "branch", &total.latbr, threadtime);
+	fprintf(fout,",\n");
+	writelatencyjson(fout, "cut", &total.latcut, threadtime);
+	fprintf(fout,",\n");
+	writelatencyjson(fout, "heuristic", &total.latheur, threadtime);
+	fprintf(fout,"\n}\n");
+	printf("callback time: incumbent %.3lf, branch %.3lf, cut %.3lf, heuristic %.3lf sec (%.2lf%% of thread time)\n",
+		total.latinc.totalns*1e-09,total.latbr.totalns*1e-09,total.latcut.totalns*1e-09,total.latheur.totalns*1e-09,
+		threadtime > 0 ? 100.0*cbtime/threadtime : 0.0);
+  }
+#endif
   CPXgetbestobjval(env, lp, &cutoff);
-  CPXgetobjval(env, lp, &objval);
+  if (CPXgetobjval(env, lp, &objval) == 0) hasincumbent = true;
+  if (opt.stringset["telemetry"]){
+	writesnapshot(&tel, ts, nthreads, CPXgetnodecnt(env, lp), CPXgetnodeleftcnt(env, lp), cutoff, hasincumbent ? objval : NAN, true);
+	if (tel.failed > 0) printf("WARNING: %ld of %ld telemetry snapshots could not be written to %s\n",
+	                           tel.failed, tel.failed+tel.writes, tel.path.c_str());
+  }
 
   status = CPXgetstat(env, lp);
   switch (status){
@@ -702,20 +3056,28 @@ int main(int argc, const char *argv[])
     default:
       opt_stat = "OTHER_EXIT";
   }
-  printf("\nBRANCH-AND-HOLE: nodes %i bound %.10f sol %.10f %s cuts %d incs %d/%d branch %d/%d\n", CPXgetnodecnt(env, lp), cutoff, objval, opt_stat.c_str(), cuts_tot, increjected, inccalled, brstr, brchange);
-  fprintf(fout,"-------------------------------\nFINAL: nodes %i bound %.10f sol %.10f %s\n", CPXgetnodecnt(env, lp), cutoff, objval, opt_stat.c_str());
+  printf("\nBRANCH-AND-HOLE: nodes %i bound %.10f sol %.10f %s cuts %d incs %d/%d branch %d/%d time %.2lf\n", CPXgetnodecnt(env, lp), cutoff, objval, opt_stat.c_str(), total.cuts_tot, total.increjected, total.inccalled, total.brstr, total.brchange, solvetime);
+  fprintf(fout,"-------------------------------\nFINAL: nodes %i bound %.10f sol %.10f %s time %.2lf\n", CPXgetnodecnt(env, lp), cutoff, objval, opt_stat.c_str(), solvetime);
 
 TERMINATE:
 
+   stopasynclog (&alog);
    FREEN (&ctype);
 
-   FREEN (&lbvarswithholes);
-   FREEN (&ubvarswithholes);
-   FREEN_mat (&lbholes,nvarswithholes);
-   FREEN_mat (&ubholes,nvarswithholes);
-   FREEN (&nholesvarswithholes);
-   FREEN_mat (&namevarswithholes,nvarswithholes);
+   FREEN (&colname);
+   FREEN (&colnamestore);
    FREEN (&has_hole);
+   FREEN (&rmatbeg);
+   FREEN (&rmatind);
+   FREEN (&rmatval);
+   FREEN (&glb);
+   FREEN (&gub);
+   freeholeindex (&holes);
+   if ( ts != NULL ) {
+      for (int t=0; t<nthreads; t++) freescratch (&ts[t]);
+      delete [] ts;
+   }
+   delete [] pub;
 
    /* Close files */
    if ( fout != NULL ) 
@@ -0,0 +1,52 @@
+// Authors:	Sven Wiese
+//-----------------------------------------------------
+
+#include "cbtiming.hpp"
+#include "utils.hpp"
+
+void
+mergelatency (cblatency       *total,
+              const cblatency *lat)
+{
+    total->calls += lat->calls;
+    total->totalns += lat->totalns;
+    total->maxns = XMAX (total->maxns, lat->maxns);
+    for(int b=0;b<CBLATBUCKETS;b++) total->bucket[b] += lat->bucket[b];
+}/*END mergelatency*/
+
+long long
+latencyquantile (const cblatency *lat,
+                 double          q)
+{
+    if ( lat->calls == 0 ) return 0;
+    long need = (long) ceil (q*lat->calls);
+    long seen = 0;
+    if ( need < 1 ) need = 1;
+    for(int b=0;b<CBLATBUCKETS;b++){
+        seen += lat->bucket[b];
+        if ( seen >= need ) return XMIN (2LL << b, lat->maxns);
+    }
+    return lat->maxns;
+}/*END latencyquantile*/
+
+void
+writelatencyjson (FILE            *fout,
+                  const char      *name,
+                  const cblatency *lat,
+                  double          threadtime)
+{
+    double total = lat->totalns*1e-09;
+    bool first = true;
+
+    fprintf (fout, "  \"%s\": {\"calls\": %ld, \"time\": %.6f, \"share\": %.6f, \"mean_ns\": %.0f, "
+             "\"p50_ns\": %lld, \"p90_ns\": %lld, \"p99_ns\": %lld, \"max_ns\": %lld, \"buckets\": [",
+             name, lat->calls, total, threadtime > 0 ? total/threadtime : 0.0,
+             lat->calls > 0 ? (double) lat->totalns/lat->calls : 0.0,
+             latencyquantile (lat, 0.5), latencyquantile (lat, 0.9), latencyquantile (lat, 0.99), lat->maxns);
+    for(int b=0;b<CBLATBUCKETS;b++){
+        if ( lat->bucket[b] == 0 ) continue;
+        fprintf (fout, "%s[%lld, %ld]", first ? "" : ", ", b > 0 ? 1LL << b : 0LL, lat->bucket[b]);
+        first = false;
+    }
+    fprintf (fout, "]}");
+}/*END writelatencyjson*/
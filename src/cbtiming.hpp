@@ -0,0 +1,77 @@
+// Authors:	Sven Wiese
+//-----------------------------------------------------
+#ifndef cbtiming_H
+#define cbtiming_H
+
+#include <chrono>
+#include <cstdio>
+
+/* bucket b of a latency histogram counts the calls that took
+ * [2^b, 2^(b+1)) nanoseconds, the last one all longer calls */
+#define CBLATBUCKETS  40
+
+/* Latencies of one callback on one thread. Each thread records into its
+ * own histogram, without locks; the histograms of all threads are
+ * merged at the end of the run. */
+struct cblatency {
+
+   cblatency() :	calls(0),
+			totalns(0),
+			maxns(0),
+			bucket(){}
+
+   long calls;
+   long long totalns;
+   long long maxns;
+   long bucket[CBLATBUCKETS];
+};
+
+/* Records one call that took ns nanoseconds. */
+inline void
+addlatency (cblatency *lat,
+            long long ns)
+{
+    int b = ns > 1 ? 63 - __builtin_clzll ((unsigned long long) ns) : 0;
+    if ( b >= CBLATBUCKETS ) b = CBLATBUCKETS-1;
+    lat->calls++;
+    lat->totalns += ns;
+    if ( ns > lat->maxns ) lat->maxns = ns;
+    lat->bucket[b]++;
+}/*END addlatency*/
+
+/* Times the scope it lives in into a histogram. */
+struct cbtimer {
+
+   cbtimer(cblatency *l) :	lat(l),
+				start(std::chrono::steady_clock::now()){}
+   ~cbtimer(){
+      addlatency (lat, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now () - start).count ());
+   }
+
+   cblatency *lat;
+   std::chrono::steady_clock::time_point start;
+};
+
+/* Adds the calls recorded in lat to total. */
+void
+mergelatency (cblatency       *total,
+              const cblatency *lat);
+
+/* Upper edge in nanoseconds of the bucket that holds the q-quantile of
+ * the latencies, at most the longest call; 0 without calls. */
+long long
+latencyquantile (const cblatency *lat,
+                 double          q);
+
+/* Writes lat as the JSON member "name": {...}, with the number of calls,
+ * total time, share of threadtime (the solve time summed over the
+ * threads), mean/p50/p90/p99/max latency and the nonempty buckets as
+ * [lower edge in ns, calls] pairs. */
+void
+writelatencyjson (FILE            *fout,
+                  const char      *name,
+                  const cblatency *lat,
+                  double          threadtime);
+
+#endif
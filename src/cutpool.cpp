@@ -0,0 +1,251 @@
+// Authors:	Sven Wiese
+//-----------------------------------------------------
+
+#include <cmath>
+#include <algorithm>
+
+#include "cutpool.hpp"
+#include "utils.hpp"
+
+/* cosine above which two cuts are parallel */
+#define PARALLELCOS  0.9999
+
+/* positions of the two largest coefficients of a cut */
+static void
+topcolumns (int          nz,
+            const double *val,
+            int          *k1_p,
+            int          *k2_p)
+{
+    int k1 = 0;
+    int k2 = -1;
+    for(int k=1;k<nz;k++){
+        if ( fabs (val[k]) > fabs (val[k1]) ) {
+            k2 = k1;
+            k1 = k;
+        } else if ( k2 < 0 || fabs (val[k]) > fabs (val[k2]) ) {
+            k2 = k;
+        }
+    }
+    *k1_p = k1;
+    *k2_p = k2;
+}/*END topcolumns*/
+
+/* dot product of two sparse vectors with ascending indices */
+static double
+sparsedot (int          nz1,
+           const int    *ind1,
+           const double *val1,
+           int          nz2,
+           const int    *ind2,
+           const double *val2)
+{
+    double dot = 0;
+    int k1 = 0;
+    int k2 = 0;
+    while ( k1 < nz1 && k2 < nz2 ) {
+        if ( ind1[k1] < ind2[k2] ) k1++;
+        else if ( ind1[k1] > ind2[k2] ) k2++;
+        else dot += val1[k1++]*val2[k2++];
+    }
+    return dot;
+}/*END sparsedot*/
+
+static void
+indexcut (cutpool *pool,
+          int     c)
+{
+    const poolcut &cut = pool->cuts[c];
+    int k1, k2;
+    topcolumns (cut.nz, &pool->val[cut.beg], &k1, &k2);
+    pool->bycolumn.insert(std::make_pair(pool->ind[cut.beg+k1], c));
+    if ( k2 >= 0 ) pool->bycolumn.insert(std::make_pair(pool->ind[cut.beg+k2], c));
+}/*END indexcut*/
+
+/* turns an alive cut into a tombstone or drops an alive cut or a
+ * tombstone */
+static void
+retirecut (cutpool *pool,
+           int     c,
+           int     state)
+{
+    poolcut &cut = pool->cuts[c];
+    if ( cut.state == POOLCUT_ALIVE ) {
+        pool->nalive--;
+        pool->nzalive -= cut.nz;
+    } else if ( cut.state == POOLCUT_TOMB ) {
+        pool->ntomb--;
+        pool->nztomb -= cut.nz;
+    }
+    cut.state = state;
+    cut.age = 0;
+    if ( state == POOLCUT_TOMB ) {
+        pool->ntomb++;
+        pool->nztomb += cut.nz;
+    }
+}/*END retirecut*/
+
+/* drop the storage of dead cuts and rebuild the column index */
+static void
+compactpool (cutpool *pool)
+{
+    std::vector<poolcut> cuts;
+    std::vector<int> ind;
+    std::vector<double> val;
+
+    cuts.reserve(pool->nalive + pool->ntomb);
+    ind.reserve(pool->nzalive + pool->nztomb);
+    val.reserve(pool->nzalive + pool->nztomb);
+    pool->bycolumn.clear();
+
+    for(size_t c=0;c<pool->cuts.size();c++){
+        poolcut cut = pool->cuts[c];
+        if ( cut.state == POOLCUT_DEAD ) continue;
+        ind.insert(ind.end(), pool->ind.begin()+cut.beg, pool->ind.begin()+cut.beg+cut.nz);
+        val.insert(val.end(), pool->val.begin()+cut.beg, pool->val.begin()+cut.beg+cut.nz);
+        cut.beg = (int)ind.size() - cut.nz;
+        cuts.push_back(cut);
+    }
+    pool->cuts.swap(cuts);
+    pool->ind.swap(ind);
+    pool->val.swap(val);
+    for(size_t c=0;c<pool->cuts.size();c++) indexcut (pool, (int)c);
+}/*END compactpool*/
+
+/* drop tombstones, then evict the oldest cuts, until nz more nonzeros
+ * fit into the pool */
+static void
+makeroom (cutpool *pool,
+          int     nz)
+{
+    if ( pool->maxnz <= 0 ) return;
+    if ( (long)pool->ind.size() + nz <= pool->maxnz ) return;
+
+    if ( pool->nzalive + pool->nztomb + nz > pool->maxnz ) {
+        std::vector< std::pair<int,int> > byage;
+        for(size_t c=0;c<pool->cuts.size();c++){
+            const poolcut &cut = pool->cuts[c];
+            if ( cut.state == POOLCUT_TOMB ) byage.push_back(std::make_pair(-cut.age - pool->maxage - 1, (int)c));
+            else if ( cut.state == POOLCUT_ALIVE ) byage.push_back(std::make_pair(-cut.age, (int)c));
+        }
+        std::sort(byage.begin(), byage.end());
+        for(size_t k=0;k<byage.size() && pool->nzalive + pool->nztomb + nz > pool->maxnz;k++){
+            if ( pool->cuts[byage[k].second].state == POOLCUT_ALIVE ) pool->evicted++;
+            retirecut (pool, byage[k].second, POOLCUT_DEAD);
+        }
+    }
+    compactpool (pool);
+}/*END makeroom*/
+
+bool
+addpoolcut (cutpool      *pool,
+            int          nz,
+            const int    *ind,
+            const double *val,
+            double       rhs,
+            const double *x)
+{
+    std::lock_guard<std::mutex> guard(pool->lock);
+
+    double norm = 0;
+    for(int k=0;k<nz;k++) norm += val[k]*val[k];
+    norm = sqrt(norm);
+    if ( nz == 0 || norm < EPSZERO ) return false;
+    rhs /= norm;
+
+    /* candidates: the cuts that have one of the two largest
+     * coefficients of this cut among their two largest */
+    int top[2];
+    topcolumns (nz, val, &top[0], &top[1]);
+
+    long stamp = ++pool->lookups;
+    bool hit = false;
+    typedef std::unordered_multimap<int, int>::iterator iter;
+    for(int t=0;t<2;t++){
+        if ( top[t] < 0 ) continue;
+        std::pair<iter,iter> range = pool->bycolumn.equal_range(ind[top[t]]);
+        for(iter it=range.first;it!=range.second;++it){
+            poolcut &cut = pool->cuts[it->second];
+            if ( cut.state == POOLCUT_DEAD || cut.stamp == stamp ) continue;
+            cut.stamp = stamp;
+            double cosine = sparsedot (nz, ind, val, cut.nz, &pool->ind[cut.beg], &pool->val[cut.beg])/norm;
+            if ( cosine < PARALLELCOS ) continue;
+
+            hit = true;
+            if ( rhs <= cut.rhs + EPSRHS ) {
+                double lhs = 0;
+                for(int k=cut.beg;k<cut.beg+cut.nz;k++) lhs += pool->val[k]*x[pool->ind[k]];
+                if ( !cut.readd && lhs >= cut.rhs - EPSVIOL ) {
+                    /* not stronger than the pooled cut or its copy in the LP */
+                    pool->hits++;
+                    pool->rejected++;
+                    if ( cut.state == POOLCUT_TOMB ) pool->tombhits++;
+                    return false;
+                }
+                /* the solver has purged the pooled cut, the new one
+                 * takes its place */
+                pool->readded++;
+            } else if ( cut.state == POOLCUT_ALIVE ) {
+                pool->replaced++;
+            }
+            retirecut (pool, it->second, POOLCUT_DEAD);
+        }
+    }
+    if ( hit ) pool->hits++;
+
+    makeroom (pool, nz);
+
+    poolcut cut;
+    cut.beg = (int)pool->ind.size();
+    cut.nz = nz;
+    cut.rhs = rhs;
+    cut.age = 0;
+    cut.state = POOLCUT_ALIVE;
+    cut.readd = false;
+    cut.stamp = stamp;
+    for(int k=0;k<nz;k++){
+        pool->ind.push_back(ind[k]);
+        pool->val.push_back(val[k]/norm);
+    }
+    pool->cuts.push_back(cut);
+    indexcut (pool, (int)pool->cuts.size() - 1);
+    pool->nalive++;
+    pool->nzalive += nz;
+
+    return true;
+}/*END addpoolcut*/
+
+void
+agepoolcuts (cutpool      *pool,
+             const double *x)
+{
+    std::lock_guard<std::mutex> guard(pool->lock);
+
+    for(size_t c=0;c<pool->cuts.size();c++){
+        poolcut &cut = pool->cuts[c];
+        if ( cut.state == POOLCUT_TOMB ) {
+            /* by now cplex has purged its copy if it stayed slack */
+            if ( ++cut.age > pool->maxage ) retirecut (pool, (int)c, POOLCUT_DEAD);
+            continue;
+        }
+        if ( cut.state != POOLCUT_ALIVE ) continue;
+        double lhs = 0;
+        for(int k=cut.beg;k<cut.beg+cut.nz;k++) lhs += pool->val[k]*x[pool->ind[k]];
+        /* a cut that is in the LP is never violated there: a violated
+         * one has been purged and must be added again when it is next
+         * separated, it does not count as binding */
+        if ( lhs < cut.rhs - EPSVIOL ) {
+            cut.readd = true;
+        } else if ( lhs < cut.rhs + EPSVIOL ) {
+            cut.age = 0;
+            continue;
+        }
+        if ( ++cut.age > pool->maxage ) {
+            retirecut (pool, (int)c, POOLCUT_TOMB);
+            pool->agedout++;
+        }
+    }
+
+    /* reclaim the storage once most of it is dead */
+    if ( 2*(pool->nzalive + pool->nztomb) < (long)pool->ind.size() ) compactpool (pool);
+}/*END agepoolcuts*/
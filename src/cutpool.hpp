@@ -0,0 +1,96 @@
+// Authors:	Sven Wiese
+//-----------------------------------------------------
+#ifndef cutpool_H
+#define cutpool_H
+
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/* Pool of the global cuts handed to the solver. Cuts are stored scaled
+ * to unit norm and indexed by their two largest coefficients, so that
+ * duplicates and near-parallel cuts (cosine above 0.9999) that are
+ * not stronger than a pooled one can be rejected before they reach the
+ * LP. Cuts that have not been binding for maxage rounds are aged out
+ * but kept as tombstones for another maxage rounds, since their copy
+ * may still be in the LP; a new cut parallel to a tombstone is rejected
+ * as well. A pooled cut that is violated at the current point has been
+ * dropped from the LP by the solver, so a parallel cut is then accepted
+ * and takes its place. The number of nonzeros kept is bounded by
+ * maxnz. The column indices of a cut must be ascending.
+ * All functions may be called from several threads. */
+#define POOLCUT_ALIVE  0
+#define POOLCUT_TOMB   1
+#define POOLCUT_DEAD   2
+
+struct poolcut {
+   int beg;           /* offset into ind/val */
+   int nz;
+   double rhs;        /* scaled right hand side */
+   int age;           /* rounds since the cut was last binding, or aged out */
+   int state;
+   bool readd;        /* found violated, its copy has left the LP */
+   long stamp;        /* last lookup that compared against the cut */
+};
+
+struct cutpool {
+
+   cutpool() :	maxnz(0),
+		maxage(0),
+		nalive(0),
+		nzalive(0),
+		ntomb(0),
+		nztomb(0),
+		lookups(0),
+		hits(0),
+		rejected(0),
+		replaced(0),
+		readded(0),
+		tombhits(0),
+		agedout(0),
+		evicted(0){}
+
+   int maxnz;
+   int maxage;
+   std::vector<poolcut> cuts;
+   std::vector<int> ind;
+   std::vector<double> val;
+   std::unordered_multimap<int, int> bycolumn;   /* column -> cuts */
+   int nalive;
+   long nzalive;
+   int ntomb;
+   long nztomb;
+   long lookups;
+   long hits;         /* lookups that found a parallel pooled cut */
+   long rejected;     /* cuts rejected as duplicates */
+   long replaced;     /* pooled cuts replaced by a stronger parallel one */
+   long readded;      /* pooled cuts dropped from the LP and added again */
+   long tombhits;     /* ... of the rejected ones, parallel to a tombstone */
+   long agedout;
+   long evicted;
+   std::mutex lock;
+};
+
+/* Offers the cut sum_k val[k] x_ind[k] >= rhs, separated at the point
+ * x, to the pool. Returns true if the cut is new and should be added
+ * to the LP, false if a parallel pooled cut is at least as strong and
+ * still in the LP, i.e. not violated at x. */
+bool
+addpoolcut (cutpool      *pool,
+            int          nz,
+            const int    *ind,
+            const double *val,
+            double       rhs,
+            const double *x);
+
+/* One aging round at the point x: binding cuts are refreshed, violated
+ * ones are marked to be added again, cuts that have not been binding
+ * for more than maxage rounds become tombstones, and tombstones older
+ * than maxage rounds are dropped. Scans the whole pool under the lock,
+ * so it is meant for the root rounds only. */
+void
+agepoolcuts (cutpool      *pool,
+             const double *x);
+
+#endif
@@ -0,0 +1,478 @@
+// Authors:	Sven Wiese
+//-----------------------------------------------------
+
+#include <cmath>
+#include <algorithm>
+
+#include "dualsimplex.hpp"
+#include "utils.hpp"
+
+#define DS_TOLPRIMAL  1E-07
+#define DS_TOLDUAL    1E-07
+#define DS_TOLPIVOT   1E-07
+#define DS_TOLSINGULAR 1E-11
+#define DS_BIGBOUND   1E+07   /* artificial bound of nonbasic variables */
+#define DS_MAXBIGBOUND 1E+13  /* ... up to which it is moved out */
+#define DS_REFACTOR   100     /* pivots between two factorizations */
+
+/* value of nonbasic variable j, artificial if its bound is infinite */
+static double
+nonbasicvalue (const dualsimplex *ds,
+               int               j)
+{
+    switch ( ds->stat[j] ) {
+    case DS_ATLB:
+        return std::isinf (ds->lb[j]) ? -ds->bigbound : ds->lb[j];
+    case DS_ATUB:
+        return std::isinf (ds->ub[j]) ? ds->bigbound : ds->ub[j];
+    default:
+        return 0;
+    }
+}/*END nonbasicvalue*/
+
+static bool
+atartificialbound (const dualsimplex *ds,
+                   int               j)
+{
+    return (ds->stat[j] == DS_ATLB && std::isinf (ds->lb[j])) ||
+           (ds->stat[j] == DS_ATUB && std::isinf (ds->ub[j]));
+}/*END atartificialbound*/
+
+/* y^T a_j for column j of [A -I] */
+static double
+dotcolumn (const dualsimplex *ds,
+           const double      *y,
+           int               j)
+{
+    if ( j >= ds->n ) return -y[j - ds->n];
+    double s = 0;
+    for(int k=ds->matbeg[j];k<ds->matbeg[j+1];k++) s += y[ds->matind[k]]*ds->matval[k];
+    return s;
+}/*END dotcolumn*/
+
+/* Checks the dual ray of row r (rho) against the true bounds: with x_p
+ * = -sum_j alpha_j x_j over the nonbasic variables, the violated bound
+ * of the basic variable p must be out of reach even without the
+ * artificial bounds. */
+static bool
+provesinfeasible (const dualsimplex *ds,
+                  int               r,
+                  const double      *rho,
+                  bool              tolb)
+{
+    int p = ds->head[r];
+    double sup = 0;    /* largest value of x_p (tolb) or -x_p */
+    for(int j=0;j<ds->n+ds->m;j++){
+        if ( ds->stat[j] == DS_BASIC ) continue;
+        double a = dotcolumn (ds, rho, j);
+        if ( tolb ) a = -a;
+        double bd = a > 0 ? ds->ub[j] : ds->lb[j];
+        if ( std::isinf (bd) ) {
+            if ( fabs (a) > DS_TOLPIVOT ) return false;
+            continue;
+        }
+        sup += a*bd;
+    }
+    return tolb ? sup < ds->lb[p] - DS_TOLPRIMAL : sup < -ds->ub[p] - DS_TOLPRIMAL;
+}/*END provesinfeasible*/
+
+/* pivot column B^-1 a_q into ds->colalpha */
+static void
+pivotcolumn (dualsimplex *ds,
+             int         q)
+{
+    int m = ds->m;
+    std::vector<double> &alpha = ds->colalpha;
+    if ( q >= ds->n ) {
+        for(int i=0;i<m;i++) alpha[i] = -ds->binv[(size_t)i*m + (q - ds->n)];
+    } else {
+        std::fill (alpha.begin(), alpha.end(), 0.0);
+        for(int k=ds->matbeg[q];k<ds->matbeg[q+1];k++){
+            int row = ds->matind[k];
+            double v = ds->matval[k];
+            for(int i=0;i<m;i++) alpha[i] += ds->binv[(size_t)i*m + row]*v;
+        }
+    }
+}/*END pivotcolumn*/
+
+/* Checks that moving the nonbasic variable j away from its artificial
+ * bound is a primal ray: the objective improves and the basic variables
+ * x_B = -B^-1 N x_N only move towards infinite bounds. */
+static bool
+provesunbounded (dualsimplex *ds,
+                 int         j)
+{
+    double dir = ds->stat[j] == DS_ATLB ? -1 : 1;
+    if ( ds->d[j]*dir > -DS_TOLDUAL ) return false;
+    pivotcolumn (ds, j);
+    for(int i=0;i<ds->m;i++){
+        int h = ds->head[i];
+        double dx = -ds->colalpha[i]*dir;
+        if ( dx > DS_TOLPIVOT && !std::isinf (ds->ub[h]) ) return false;
+        if ( dx < -DS_TOLPIVOT && !std::isinf (ds->lb[h]) ) return false;
+    }
+    return true;
+}/*END provesunbounded*/
+
+static void
+slackbasis (dualsimplex *ds)
+{
+    for(int j=0;j<ds->n;j++) ds->stat[j] = DS_ATLB;
+    for(int i=0;i<ds->m;i++){
+        ds->stat[ds->n+i] = DS_BASIC;
+        ds->head[i] = ds->n+i;
+    }
+    ds->factorok = false;
+}/*END slackbasis*/
+
+/* Gauss-Jordan inversion of the basis matrix. A singular basis is
+ * replaced by the slack basis, whose inverse is -I. */
+static void
+factor (dualsimplex *ds)
+{
+    int m = ds->m;
+    std::vector<double> b((size_t)m*m, 0.0);
+    std::vector<double> &inv = ds->binv;
+
+    for(int r=0;r<m;r++){
+        int j = ds->head[r];
+        if ( j >= ds->n ) {
+            b[(size_t)(j - ds->n)*m + r] = -1;
+        } else {
+            for(int k=ds->matbeg[j];k<ds->matbeg[j+1];k++) b[(size_t)ds->matind[k]*m + r] = ds->matval[k];
+        }
+    }
+    std::fill (inv.begin(), inv.end(), 0.0);
+    for(int i=0;i<m;i++) inv[(size_t)i*m + i] = 1;
+
+    for(int c=0;c<m;c++){
+        int p = c;
+        for(int i=c+1;i<m;i++){
+            if ( fabs (b[(size_t)i*m + c]) > fabs (b[(size_t)p*m + c]) ) p = i;
+        }
+        if ( fabs (b[(size_t)p*m + c]) < DS_TOLSINGULAR ) {
+            slackbasis (ds);
+            std::fill (inv.begin(), inv.end(), 0.0);
+            for(int i=0;i<m;i++) inv[(size_t)i*m + i] = -1;
+            ds->factorok = true;
+            ds->nupdates = 0;
+            return;
+        }
+        if ( p != c ) {
+            std::swap_ranges (b.begin() + (size_t)p*m, b.begin() + (size_t)(p+1)*m, b.begin() + (size_t)c*m);
+            std::swap_ranges (inv.begin() + (size_t)p*m, inv.begin() + (size_t)(p+1)*m, inv.begin() + (size_t)c*m);
+        }
+        double piv = b[(size_t)c*m + c];
+        double *bc = &b[(size_t)c*m];
+        double *ic = &inv[(size_t)c*m];
+        for(int k=0;k<m;k++){
+            bc[k] /= piv;
+            ic[k] /= piv;
+        }
+        for(int i=0;i<m;i++){
+            double f = b[(size_t)i*m + c];
+            if ( i == c || f == 0 ) continue;
+            double *bi = &b[(size_t)i*m];
+            double *ii = &inv[(size_t)i*m];
+            for(int k=0;k<m;k++){
+                bi[k] -= f*bc[k];
+                ii[k] -= f*ic[k];
+            }
+        }
+    }
+    ds->factorok = true;
+    ds->nupdates = 0;
+}/*END factor*/
+
+/* reduced costs d = c - A^T y with y^T = c_B^T B^-1 */
+static void
+computedual (dualsimplex *ds)
+{
+    int m = ds->m;
+    std::vector<double> y(m, 0.0);
+    for(int r=0;r<m;r++){
+        double cb = ds->cost[ds->head[r]];
+        if ( cb == 0 ) continue;
+        const double *row = &ds->binv[(size_t)r*m];
+        for(int i=0;i<m;i++) y[i] += cb*row[i];
+    }
+    for(int j=0;j<ds->n+m;j++){
+        ds->d[j] = (ds->stat[j] == DS_BASIC) ? 0 : ds->cost[j] - dotcolumn (ds, &y[0], j);
+    }
+}/*END computedual*/
+
+/* puts every nonbasic variable on the bound its reduced cost asks for */
+static void
+makedualfeasible (dualsimplex *ds)
+{
+    for(int j=0;j<ds->n+ds->m;j++){
+        if ( ds->stat[j] == DS_BASIC ) continue;
+        bool haslb = !std::isinf (ds->lb[j]);
+        bool hasub = !std::isinf (ds->ub[j]);
+        if ( ds->lb[j] == ds->ub[j] || ds->d[j] > DS_TOLDUAL ) {
+            ds->stat[j] = DS_ATLB;
+        } else if ( ds->d[j] < -DS_TOLDUAL ) {
+            ds->stat[j] = DS_ATUB;
+        } else if ( ds->stat[j] == DS_ATLB && haslb ) {
+            continue;
+        } else if ( ds->stat[j] == DS_ATUB && hasub ) {
+            continue;
+        } else {
+            ds->stat[j] = haslb ? DS_ATLB : (hasub ? DS_ATUB : DS_FREE);
+        }
+    }
+}/*END makedualfeasible*/
+
+/* x_B = -B^-1 N x_N */
+static void
+computeprimal (dualsimplex *ds)
+{
+    int m = ds->m;
+    std::vector<double> w(m, 0.0);
+    for(int j=0;j<ds->n+m;j++){
+        if ( ds->stat[j] == DS_BASIC ) continue;
+        double v = nonbasicvalue (ds, j);
+        ds->x[j] = v;
+        if ( v == 0 ) continue;
+        if ( j >= ds->n ) {
+            w[j - ds->n] += v;
+        } else {
+            for(int k=ds->matbeg[j];k<ds->matbeg[j+1];k++) w[ds->matind[k]] -= ds->matval[k]*v;
+        }
+    }
+    for(int r=0;r<m;r++){
+        const double *row = &ds->binv[(size_t)r*m];
+        double s = 0;
+        for(int i=0;i<m;i++) s += row[i]*w[i];
+        ds->x[ds->head[r]] = s;
+    }
+}/*END computeprimal*/
+
+static void
+refresh (dualsimplex *ds)
+{
+    if ( !ds->factorok || ds->nupdates > 0 ) factor (ds);
+    computedual (ds);
+    makedualfeasible (ds);
+    computeprimal (ds);
+}/*END refresh*/
+
+void
+initdualsimplex (dualsimplex  *ds,
+                 int          m,
+                 int          n,
+                 const double *obj,
+                 const int    *matbeg,
+                 const int    *matind,
+                 const double *matval,
+                 const double *lb,
+                 const double *ub,
+                 const double *rowlo,
+                 const double *rowhi)
+{
+    ds->m = m;
+    ds->n = n;
+    ds->matbeg.assign (matbeg, matbeg + n + 1);
+    ds->matind.assign (matind, matind + matbeg[n]);
+    ds->matval.assign (matval, matval + matbeg[n]);
+    ds->cost.assign (n + m, 0.0);
+    ds->lb.resize (n + m);
+    ds->ub.resize (n + m);
+    for(int j=0;j<n;j++){
+        ds->cost[j] = obj[j];
+        ds->lb[j] = lb[j];
+        ds->ub[j] = ub[j];
+    }
+    for(int i=0;i<m;i++){
+        ds->lb[n+i] = rowlo[i];
+        ds->ub[n+i] = rowhi[i];
+    }
+    ds->x.assign (n + m, 0.0);
+    ds->d.assign (n + m, 0.0);
+    ds->head.resize (m);
+    ds->stat.resize (n + m);
+    ds->binv.assign ((size_t)m*m, 0.0);
+    ds->rowalpha.assign (n + m, 0.0);
+    ds->colalpha.assign (m, 0.0);
+    ds->nupdates = 0;
+    ds->iters = 0;
+    ds->objval = 0;
+    slackbasis (ds);
+}/*END initdualsimplex*/
+
+void
+setdualsimplexbounds (dualsimplex *ds,
+                      int         j,
+                      double      lo,
+                      double      up)
+{
+    ds->lb[j] = lo;
+    ds->ub[j] = up;
+}/*END setdualsimplexbounds*/
+
+void
+setdualsimplexbasis (dualsimplex                    *ds,
+                     const std::vector<signed char> &stat)
+{
+    int nbasic = 0;
+    for(int j=0;j<ds->n+ds->m;j++){
+        if ( stat[j] == DS_BASIC ) {
+            if ( nbasic == ds->m ) break;
+            ds->head[nbasic] = j;
+        }
+        nbasic += stat[j] == DS_BASIC;
+    }
+    if ( nbasic != ds->m ) {
+        slackbasis (ds);
+        return;
+    }
+    ds->stat = stat;
+    ds->factorok = false;
+}/*END setdualsimplexbasis*/
+
+int
+solvedualsimplex (dualsimplex *ds,
+                  long        itlim)
+{
+    int m = ds->m;
+    int n = ds->n;
+    long start = ds->iters;
+    bool fresh = true;      /* factorization without updates */
+
+    ds->bigbound = DS_BIGBOUND;
+    refresh (ds);
+
+    for(;;){
+        if ( ds->nupdates >= DS_REFACTOR ) {
+            refresh (ds);
+            fresh = true;
+        }
+
+        /* leaving variable: largest bound violation */
+        int r = -1;
+        double maxviol = DS_TOLPRIMAL;
+        for(int i=0;i<m;i++){
+            int j = ds->head[i];
+            double viol = XMAX (ds->lb[j] - ds->x[j], ds->x[j] - ds->ub[j]);
+            if ( viol > maxviol ) {
+                maxviol = viol;
+                r = i;
+            }
+        }
+        if ( r < 0 ) {
+            if ( !fresh ) {
+                /* confirm on a fresh factorization */
+                refresh (ds);
+                fresh = true;
+                continue;
+            }
+            /* a variable held by its artificial bound either proves
+             * the LP unbounded or needs the bound further out */
+            bool held = false;
+            for(int j=0;j<n+m;j++){
+                if ( ds->stat[j] == DS_BASIC || !atartificialbound (ds, j) || fabs (ds->d[j]) <= DS_TOLDUAL ) continue;
+                if ( provesunbounded (ds, j) ) return LP_UNBOUNDED;
+                held = true;
+            }
+            if ( held ) {
+                if ( ds->bigbound >= DS_MAXBIGBOUND ) return LP_NUMERIC;
+                ds->bigbound *= 1000;
+                refresh (ds);
+                continue;
+            }
+            ds->objval = 0;
+            for(int j=0;j<n+m;j++) ds->objval += ds->cost[j]*ds->x[j];
+            return LP_OPTIMAL;
+        }
+        if ( ds->iters - start >= itlim ) return LP_ITLIM;
+
+        int p = ds->head[r];
+        bool tolb = ds->x[p] < ds->lb[p];
+        const double *rho = &ds->binv[(size_t)r*m];
+
+        /* pivot row and Harris ratio test: with the leaving variable
+         * going to its lower bound, the reduced costs move by t*alpha */
+        double tmax = HUGE_VAL;
+        for(int j=0;j<n+m;j++){
+            if ( ds->stat[j] == DS_BASIC || ds->lb[j] == ds->ub[j] ) continue;
+            double a = dotcolumn (ds, rho, j);
+            ds->rowalpha[j] = a;
+            if ( !tolb ) a = -a;
+            double dj;
+            if ( ds->stat[j] == DS_ATLB && a < -DS_TOLPIVOT ) dj = ds->d[j];
+            else if ( ds->stat[j] == DS_ATUB && a > DS_TOLPIVOT ) dj = -ds->d[j];
+            else if ( ds->stat[j] == DS_FREE && fabs (a) > DS_TOLPIVOT ) dj = fabs (ds->d[j]);
+            else continue;
+            tmax = XMIN (tmax, (XMAX (dj, 0.0) + DS_TOLDUAL)/fabs (a));
+        }
+        if ( std::isinf (tmax) ) {
+            if ( !fresh ) {
+                refresh (ds);
+                fresh = true;
+                continue;
+            }
+            return provesinfeasible (ds, r, rho, tolb) ? LP_INFEASIBLE : LP_NUMERIC;
+        }
+        int q = -1;
+        double maxalpha = 0;
+        for(int j=0;j<n+m;j++){
+            if ( ds->stat[j] == DS_BASIC || ds->lb[j] == ds->ub[j] ) continue;
+            double a = tolb ? ds->rowalpha[j] : -ds->rowalpha[j];
+            double dj;
+            if ( ds->stat[j] == DS_ATLB && a < -DS_TOLPIVOT ) dj = ds->d[j];
+            else if ( ds->stat[j] == DS_ATUB && a > DS_TOLPIVOT ) dj = -ds->d[j];
+            else if ( ds->stat[j] == DS_FREE && fabs (a) > DS_TOLPIVOT ) dj = fabs (ds->d[j]);
+            else continue;
+            if ( XMAX (dj, 0.0)/fabs (a) <= tmax && fabs (a) > maxalpha ) {
+                maxalpha = fabs (a);
+                q = j;
+            }
+        }
+
+        /* pivot column B^-1 a_q */
+        std::vector<double> &alpha = ds->colalpha;
+        pivotcolumn (ds, q);
+        double piv = alpha[r];
+        if ( fabs (piv) < DS_TOLPIVOT || fabs (piv - ds->rowalpha[q]) > 1e-6*(1 + fabs (piv)) ) {
+            /* the updated inverse has drifted */
+            if ( !fresh ) {
+                refresh (ds);
+                fresh = true;
+                continue;
+            }
+            if ( fabs (piv) < DS_TOLSINGULAR ) return LP_NUMERIC;
+        }
+
+        /* dual step */
+        double delta = -ds->d[q]/piv;
+        for(int j=0;j<n+m;j++){
+            if ( ds->stat[j] == DS_BASIC || ds->lb[j] == ds->ub[j] ) continue;
+            ds->d[j] += delta*ds->rowalpha[j];
+        }
+        ds->d[q] = 0;
+        ds->d[p] = delta;
+
+        /* primal step */
+        double bound = tolb ? ds->lb[p] : ds->ub[p];
+        double theta = (ds->x[p] - bound)/piv;
+        ds->x[q] += theta;
+        for(int i=0;i<m;i++) ds->x[ds->head[i]] -= theta*alpha[i];
+        ds->x[p] = bound;
+        ds->stat[p] = tolb ? DS_ATLB : DS_ATUB;
+        ds->stat[q] = DS_BASIC;
+        ds->head[r] = q;
+
+        /* product form update of the inverse */
+        double *rowr = &ds->binv[(size_t)r*m];
+        for(int k=0;k<m;k++) rowr[k] /= piv;
+        for(int i=0;i<m;i++){
+            double f = alpha[i];
+            if ( i == r || f == 0 ) continue;
+            double *rowi = &ds->binv[(size_t)i*m];
+            for(int k=0;k<m;k++) rowi[k] -= f*rowr[k];
+        }
+        ds->nupdates++;
+        ds->iters++;
+        fresh = false;
+    }
+}/*END solvedualsimplex*/
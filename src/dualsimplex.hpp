@@ -0,0 +1,103 @@
+// Authors:	Sven Wiese
+//-----------------------------------------------------
+#ifndef dualsimplex_H
+#define dualsimplex_H
+
+#include <vector>
+
+/* Solution status of solvedualsimplex. */
+#define LP_OPTIMAL     1
+#define LP_INFEASIBLE  2
+#define LP_UNBOUNDED   3
+#define LP_ITLIM       4
+#define LP_NUMERIC     5   /* singular basis, or infeasibility or
+                              unboundedness without a proof */
+
+/* Status of a variable in the basis. */
+#define DS_BASIC  0
+#define DS_ATLB   1
+#define DS_ATUB   2
+#define DS_FREE   3   /* nonbasic free variable at zero */
+
+/* Bounded-variable dual simplex for
+ *   min c^T x  s.t.  rowlo <= A x <= rowhi,  lb <= x <= ub,
+ * written as [A -I](x,s) = 0 with the row activities s as slack
+ * variables n..n+m-1. The basis inverse is kept dense and updated in
+ * product form, so the LP should have at most a few thousand rows.
+ * Nonbasic variables whose reduced cost calls for an infinite bound
+ * are put on an artificial bound; if one is still there at the optimum
+ * the LP is reported unbounded when a primal ray proves it, otherwise
+ * the artificial bounds are moved further out. After changing bounds,
+ * the LP is reoptimized from the last basis, which stays dual feasible. */
+struct dualsimplex {
+
+   dualsimplex() :	m(0),
+			n(0),
+			nupdates(0),
+			factorok(false),
+			bigbound(0),
+			objval(0),
+			iters(0){}
+
+   int m;
+   int n;
+   std::vector<int> matbeg;       /* A by column */
+   std::vector<int> matind;
+   std::vector<double> matval;
+   std::vector<double> cost;      /* [n+m] */
+   std::vector<double> lb;        /* [n+m] */
+   std::vector<double> ub;
+   std::vector<double> x;         /* [n+m] primal values */
+   std::vector<double> d;         /* [n+m] reduced costs */
+   std::vector<int> head;         /* [m] basic variable of row r */
+   std::vector<signed char> stat; /* [n+m] DS_BASIC, DS_ATLB, ... */
+   std::vector<double> binv;      /* [m*m] basis inverse by row */
+   std::vector<double> rowalpha;  /* [n+m] pivot row */
+   std::vector<double> colalpha;  /* [m] pivot column */
+   int nupdates;                  /* pivots since the last factorization */
+   bool factorok;
+   double bigbound;               /* current artificial bound */
+   double objval;
+   long iters;                    /* total number of pivots */
+};
+
+/* Sets up the LP with n columns (obj, lb, ub, by column in
+ * matbeg/matind/matval) and m rows rowlo/rowhi, with a slack basis. */
+void
+initdualsimplex (dualsimplex  *ds,
+                 int          m,
+                 int          n,
+                 const double *obj,
+                 const int    *matbeg,
+                 const int    *matind,
+                 const double *matval,
+                 const double *lb,
+                 const double *ub,
+                 const double *rowlo,
+                 const double *rowhi);
+
+/* Changes the bounds of column j. */
+void
+setdualsimplexbounds (dualsimplex *ds,
+                      int         j,
+                      double      lo,
+                      double      up);
+
+/* Installs the basis stat[0..n+m-1]; a basis without exactly m basic
+ * variables is replaced by the slack basis. */
+void
+setdualsimplexbasis (dualsimplex              *ds,
+                     const std::vector<signed char> &stat);
+
+/* Reoptimizes with at most itlim pivots. Returns LP_OPTIMAL,
+ * LP_INFEASIBLE, LP_UNBOUNDED, LP_ITLIM or LP_NUMERIC; on LP_OPTIMAL,
+ * the primal values are ds->x[0..n-1] and the objective is ds->objval.
+ * LP_INFEASIBLE and LP_UNBOUNDED are only returned for a dual or primal
+ * ray that holds with the true bounds; LP_NUMERIC when the basis is
+ * singular on a fresh factorization, a dual ray rests on an artificial
+ * bound, or no primal ray is found with the largest artificial bound. */
+int
+solvedualsimplex (dualsimplex *ds,
+                  long        itlim);
+
+#endif
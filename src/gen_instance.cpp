@@ -0,0 +1,318 @@
+// Authors:	Sven Wiese
+//-----------------------------------------------------
+// Generator of synthetic hole instances, does not need CPLEX.
+//
+//   gen_instance [options] name
+//
+// Writes name.mps and name_holes.txt. All variables are integer in
+// [0,range]; a share -holefrac of them has -holes holes, whose widths
+// are drawn from -width, one hole per equal slice of the domain. The
+// rows are >= and <= rows with coefficients in 1..9 around a hole-free
+// reference point, so the instance is feasible. Both files are
+// streamed: the matrix is drawn column by column from a generator
+// seeded per column, once to get the row activities of the reference
+// point and once to write it, so memory is linear in the number of
+// rows only.
+//
+//   -vars n          number of variables (default 1000)
+//   -rows m          number of rows (default vars/10)
+//   -density d       share of the rows each column appears in
+//                    (default: 3 rows per column)
+//   -holes k         holes per hole variable (default 4)
+//   -holefrac f      share of variables with holes (default 1)
+//   -range u         upper bound of the variables (default 212)
+//   -width spec      hole widths: fixed:w, uniform:a:b or geometric:mean
+//                    (default uniform:1:10)
+//   -slack s         relative slack of the rows at the reference point
+//                    (default 0.05)
+//   -seed s          random seed (default 1)
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "utils.hpp"
+
+#define GEN_BUFSIZE  (1 << 20)
+
+struct genparams {
+
+   genparams() :	nvars(1000),
+			nrows(-1),
+			density(-1),
+			nholes(4),
+			holefrac(1.0),
+			range(212),
+			widthkind('u'),
+			widtha(1),
+			widthb(10),
+			slack(0.05),
+			seed(1){}
+
+   long nvars;
+   long nrows;
+   double density;
+   int nholes;
+   double holefrac;
+   long range;
+   char widthkind;    /* 'f'ixed, 'u'niform, 'g'eometric */
+   double widtha;
+   double widthb;
+   double slack;
+   unsigned long long seed;
+};
+
+/* splitmix64, seeded per column so that every pass draws the same data */
+struct genrng {
+   unsigned long long state;
+};
+
+static unsigned long long
+nextrand (genrng *rng)
+{
+    unsigned long long z = (rng->state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}/*END nextrand*/
+
+/* uniform in [0,n) */
+static long
+randint (genrng *rng,
+         long   n)
+{
+    return (long)(nextrand (rng) % (unsigned long long)n);
+}/*END randint*/
+
+static double
+randunit (genrng *rng)
+{
+    return (nextrand (rng) >> 11) * (1.0/9007199254740992.0);
+}/*END randunit*/
+
+/* everything about column j: holes, reference value, cost and entries */
+struct gencolumn {
+   std::vector<long> hlb;
+   std::vector<long> hub;
+   long xref;
+   int cost;
+   std::vector<long> rows;
+   std::vector<int> coefs;
+};
+
+static long
+drawwidth (const genparams *par,
+           genrng          *rng)
+{
+    switch ( par->widthkind ) {
+    case 'f':
+        return (long)par->widtha;
+    case 'g': {
+        /* geometric with the given mean, at least 1 */
+        double p = 1.0/XMAX (1.0, par->widtha);
+        double u = XMAX (randunit (rng), 1e-300);
+        return 1 + (long)floor (log (u)/log (1-p+1e-300));
+    }
+    default:
+        return (long)par->widtha + randint (rng, (long)(par->widthb - par->widtha) + 1);
+    }
+}/*END drawwidth*/
+
+static void
+drawcolumn (const genparams *par,
+            long            nzcol,
+            long            j,
+            gencolumn       *col)
+{
+    genrng rng;
+    rng.state = par->seed*0x100000001B3ULL + (unsigned long long)j;
+    nextrand (&rng);
+
+    col->hlb.clear ();
+    col->hub.clear ();
+    bool holes = par->holefrac >= 1 || randunit (&rng) < par->holefrac;
+    if ( holes && par->nholes > 0 ) {
+        /* one hole per slice, strictly inside it */
+        long slice = (par->range + 1)/par->nholes;
+        for(int k=0;k<par->nholes && slice >= 3;k++){
+            long w = XMIN (drawwidth (par, &rng), slice-2);
+            if ( w < 1 ) continue;
+            long lo = k*slice + 1 + randint (&rng, slice-1-w);
+            col->hlb.push_back (lo);
+            col->hub.push_back (lo+w-1);
+        }
+    }
+
+    /* hole-free reference value */
+    col->xref = randint (&rng, par->range+1);
+    for(size_t h=0;h<col->hlb.size();h++){
+        if ( col->xref >= col->hlb[h] && col->xref <= col->hub[h] ) col->xref = col->hub[h]+1;
+    }
+    col->cost = 1 + (int)randint (&rng, 100);
+
+    col->rows.clear ();
+    col->coefs.clear ();
+    for(long k=0;k<nzcol;k++) col->rows.push_back (randint (&rng, par->nrows));
+    std::sort (col->rows.begin (), col->rows.end ());
+    col->rows.erase (std::unique (col->rows.begin (), col->rows.end ()), col->rows.end ());
+    for(size_t k=0;k<col->rows.size ();k++) col->coefs.push_back (1 + (int)randint (&rng, 9));
+}/*END drawcolumn*/
+
+static bool
+parsewidth (const char *spec,
+            genparams  *par)
+{
+    if ( !strncmp (spec, "fixed:", 6) ) {
+        par->widthkind = 'f';
+        par->widtha = atof (spec+6);
+        return par->widtha >= 1;
+    }
+    if ( !strncmp (spec, "geometric:", 10) ) {
+        par->widthkind = 'g';
+        par->widtha = atof (spec+10);
+        return par->widtha >= 1;
+    }
+    if ( !strncmp (spec, "uniform:", 8) ) {
+        par->widthkind = 'u';
+        return sscanf (spec+8, "%lf:%lf", &par->widtha, &par->widthb) == 2 &&
+               par->widtha >= 1 && par->widthb >= par->widtha;
+    }
+    return false;
+}/*END parsewidth*/
+
+int main(int argc, const char *argv[])
+{
+    int status = 0;
+    genparams par;
+    const char *name = NULL;
+    FILE *fmps = NULL;
+    FILE *fholes = NULL;
+    char *mpsbuf = NULL;
+    char *holesbuf = NULL;
+    std::vector<long long> activity;
+    gencolumn col;
+    long nzcol = 3;
+    long long nz = 0;
+    long nholevars = 0;
+    long long nholes = 0;
+
+    for(int a=1;a<argc;a++){
+        std::string o = argv[a];
+        bool hasarg = a+1 < argc;
+        if ( o == "-vars" && hasarg ) par.nvars = atol (argv[++a]);
+        else if ( o == "-rows" && hasarg ) par.nrows = atol (argv[++a]);
+        else if ( o == "-density" && hasarg ) par.density = atof (argv[++a]);
+        else if ( o == "-holes" && hasarg ) par.nholes = atoi (argv[++a]);
+        else if ( o == "-holefrac" && hasarg ) par.holefrac = atof (argv[++a]);
+        else if ( o == "-range" && hasarg ) par.range = atol (argv[++a]);
+        else if ( o == "-slack" && hasarg ) par.slack = atof (argv[++a]);
+        else if ( o == "-seed" && hasarg ) par.seed = strtoull (argv[++a], NULL, 10);
+        else if ( o == "-width" && hasarg ) {
+            if ( !parsewidth (argv[++a], &par) ) {
+                printf ("ERROR: bad width %s (fixed:w, uniform:a:b or geometric:mean)\n", argv[a]);
+                return ERR_BADARGUMENT;
+            }
+        }
+        else if ( o[0] != '-' && name == NULL ) name = argv[a];
+        else {
+            printf ("usage: gen_instance [-vars n] [-rows m] [-density d] [-holes k] [-holefrac f] [-range u]\n"
+                    "                    [-width fixed:w|uniform:a:b|geometric:mean] [-slack s] [-seed s] name\n");
+            return ERR_BADARGUMENT;
+        }
+    }
+    if ( name == NULL || par.nvars < 1 || par.range < 1 || par.nholes < 0 ) {
+        printf ("ERROR: need a name, at least one variable and a positive range\n");
+        return ERR_BADARGUMENT;
+    }
+    if ( par.nrows < 0 ) par.nrows = XMAX (1L, par.nvars/10);
+    if ( par.density > 0 ) nzcol = XMAX (1L, (long)ceil (par.density*par.nrows));
+    nzcol = XMIN (nzcol, par.nrows);
+
+    std::string mpsname = std::string (name) + ".mps";
+    std::string holesname = std::string (name) + "_holes.txt";
+    fmps = fopen (mpsname.c_str (), "w");
+    fholes = fopen (holesname.c_str (), "w");
+    mpsbuf = (char*)malloc (GEN_BUFSIZE);
+    holesbuf = (char*)malloc (GEN_BUFSIZE);
+    if ( fmps == NULL || fholes == NULL ) {
+        printf ("ERROR: cannot write %s / %s\n", mpsname.c_str (), holesname.c_str ());
+        status = ERR_OPENFILE;
+        goto TERMINATE;
+    }
+    if ( mpsbuf == NULL || holesbuf == NULL ) {
+        status = ERR_NOMEMORY;
+        goto TERMINATE;
+    }
+    setvbuf (fmps, mpsbuf, _IOFBF, GEN_BUFSIZE);
+    setvbuf (fholes, holesbuf, _IOFBF, GEN_BUFSIZE);
+
+    /* pass 1: row activities of the reference point */
+    activity.assign (par.nrows, 0);
+    for(long j=0;j<par.nvars;j++){
+        drawcolumn (&par, nzcol, j, &col);
+        for(size_t k=0;k<col.rows.size ();k++) activity[col.rows[k]] += (long long)col.coefs[k]*col.xref;
+        if ( !col.hlb.empty () ) nholevars++;
+    }
+
+    /* pass 2: the problem and the holes */
+    fprintf (fmps, "NAME          %s\n", strrchr (name, '/') != NULL ? strrchr (name, '/')+1 : name);
+    fprintf (fmps, "ROWS\n");
+    fprintf (fmps, " N  obj\n");
+    for(long i=0;i<par.nrows;i++) fprintf (fmps, " %c  c%ld\n", (i % 2 == 0) ? 'G' : 'L', i+1);
+    fprintf (fmps, "COLUMNS\n");
+    fprintf (fmps, "    MARKER                 'MARKER'                 'INTORG'\n");
+    fprintf (fholes, "%ld\n", nholevars);
+    for(long j=0;j<par.nvars;j++){
+        drawcolumn (&par, nzcol, j, &col);
+        fprintf (fmps, "    x%-7ld  obj       %12d\n", j+1, col.cost);
+        for(size_t k=0;k<col.rows.size ();k++){
+            fprintf (fmps, "    x%-7ld  c%-7ld  %12d\n", j+1, col.rows[k]+1, col.coefs[k]);
+        }
+        nz += col.rows.size ();
+        if ( col.hlb.empty () ) continue;
+        fprintf (fholes, "x%ld 0 %ld %d", j+1, par.range, (int)col.hlb.size ());
+        for(size_t h=0;h<col.hlb.size ();h++) fprintf (fholes, " %ld %ld", col.hlb[h], col.hub[h]);
+        fprintf (fholes, "\n");
+        nholes += col.hlb.size ();
+    }
+    fprintf (fmps, "    MARKER                 'MARKER'                 'INTEND'\n");
+    fprintf (fmps, "RHS\n");
+    for(long i=0;i<par.nrows;i++){
+        /* >= rows below, <= rows above the reference point */
+        long long s = (long long)floor (par.slack*activity[i]);
+        long long rhs = (i % 2 == 0) ? activity[i] - s : activity[i] + s;
+        if ( rhs != 0 ) fprintf (fmps, "    rhs       c%-7ld  %12lld\n", i+1, rhs);
+    }
+    fprintf (fmps, "BOUNDS\n");
+    for(long j=0;j<par.nvars;j++) fprintf (fmps, " UP bnd       x%-7ld  %12ld\n", j+1, par.range);
+    fprintf (fmps, "ENDATA\n");
+
+    /* a full disk shows up only when the buffers are written out */
+    {
+        bool failed = fflush (fmps) != 0 || fflush (fholes) != 0 || ferror (fmps) || ferror (fholes);
+        failed = (fclose (fmps) != 0) || failed;
+        failed = (fclose (fholes) != 0) || failed;
+        fmps = NULL;
+        fholes = NULL;
+        if ( failed ) {
+            printf ("ERROR: writing %s / %s failed\n", mpsname.c_str (), holesname.c_str ());
+            status = ERR_OPENFILE;
+            goto TERMINATE;
+        }
+    }
+    printf ("%s: %ld variables, %ld rows, %lld nonzeros; %s: %ld hole variables, %lld holes\n",
+            mpsname.c_str (), par.nvars, par.nrows, nz, holesname.c_str (), nholevars, nholes);
+
+TERMINATE:
+
+    if ( fmps != NULL ) fclose (fmps);
+    if ( fholes != NULL ) fclose (fholes);
+    FREEN (&mpsbuf);
+    FREEN (&holesbuf);
+
+    return status;
+}
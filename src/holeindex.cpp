@@ -0,0 +1,574 @@
+// Authors:	Sven Wiese
+//-----------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <sys/mman.h>
+
+#include "holeindex.hpp"
+#include "utils.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define HOLES_AVX2
+#include <immintrin.h>
+#endif
+
+int
+buildholeindex (int           nvarswithholes,
+                const double  *lbvarswithholes,
+                const double  *ubvarswithholes,
+                const int     *nholesvarswithholes,
+                char          **namevarswithholes,
+                double        **lbholes,
+                double        **ubholes,
+                holeindex     *idx)
+{
+    int status=0;
+
+    int nholes=0;
+    int namelen=0;
+    int i, j;
+
+    freeholeindex (idx);
+
+    for(i=0;i<nvarswithholes;i++){
+        nholes+=nholesvarswithholes[i];
+        namelen+=(int)strlen(namevarswithholes[i])+1;
+    }
+
+    idx->lbvar=(double*)malloc(nvarswithholes*sizeof(double));
+    idx->ubvar=(double*)malloc(nvarswithholes*sizeof(double));
+    idx->beg=(int*)malloc((nvarswithholes+1)*sizeof(int));
+    idx->lb=(double*)malloc(nholes*sizeof(double));
+    idx->ub=(double*)malloc(nholes*sizeof(double));
+    idx->namebeg=(int*)malloc((nvarswithholes+1)*sizeof(int));
+    idx->namestore=(char*)malloc(namelen*sizeof(char));
+
+    if ( idx->lbvar == NULL ||
+         idx->ubvar == NULL ||
+         idx->beg == NULL ||
+         (nholes > 0 && (idx->lb == NULL || idx->ub == NULL)) ||
+         idx->namebeg == NULL ||
+         (namelen > 0 && idx->namestore == NULL) ) {
+        status = ERR_NOMEMORY;
+        goto TERMINATE;
+    }
+
+    idx->nvars=nvarswithholes;
+    idx->beg[0]=0;
+    idx->namebeg[0]=0;
+    nholes=0;
+    namelen=0;
+
+    for(i=0;i<nvarswithholes;i++){
+        idx->lbvar[i]=lbvarswithholes[i];
+        idx->ubvar[i]=ubvarswithholes[i];
+
+        int len=(int)strlen(namevarswithholes[i])+1;
+        memcpy(idx->namestore+namelen,namevarswithholes[i],len);
+        namelen+=len;
+        idx->namebeg[i+1]=namelen;
+
+        for(j=0;j<nholesvarswithholes[i];j++){
+            idx->lb[nholes+j]=lbholes[i][j];
+            idx->ub[nholes+j]=ubholes[i][j];
+        }
+        nholes+=normalizeholes (idx->lb+nholes, idx->ub+nholes, nholesvarswithholes[i]);
+        idx->beg[i+1]=nholes;
+    }
+    idx->nholes=nholes;
+
+TERMINATE:
+
+    if ( status ) freeholeindex (idx);
+
+    return status;
+}/*END buildholeindex*/
+
+int
+normalizeholes (double *lb,
+                double *ub,
+                int    n)
+{
+    int i, k;
+    bool sorted=true;
+
+    /* hole files are usually sorted already */
+    for(i=0;i<n;i++){
+        if ( lb[i] > ub[i] || (i > 0 && lb[i] <= ub[i-1]) ) {
+            sorted=false;
+            break;
+        }
+    }
+    if ( sorted ) return n;
+
+    std::vector< std::pair<double,double> > holes;
+    holes.reserve(n);
+    for(i=0;i<n;i++){
+        if (lb[i] <= ub[i]) holes.push_back(std::make_pair(lb[i],ub[i]));
+    }
+    std::sort(holes.begin(),holes.end());
+
+    k=0;
+    for(i=0;i<(int)holes.size();i++){
+        if (k > 0 && holes[i].first <= ub[k-1]){
+            ub[k-1]=XMAX(ub[k-1],holes[i].second);
+            continue;
+        }
+        lb[k]=holes[i].first;
+        ub[k]=holes[i].second;
+        k++;
+    }
+    return k;
+}/*END normalizeholes*/
+
+int
+setholecols (holeindex *idx,
+             int       ncols,
+             const int *col)
+{
+    int status=0;
+    int i, j;
+
+    FREEN (&idx->col);
+    FREEN (&idx->colvar);
+    FREEN (&idx->hcol);
+    FREEN (&idx->hlo);
+    FREEN (&idx->hhi);
+
+    idx->col=(int*)malloc(idx->nvars*sizeof(int));
+    idx->colvar=(int*)malloc(ncols*sizeof(int));
+    idx->hcol=(int*)malloc(idx->nholes*sizeof(int));
+    idx->hlo=(double*)malloc(idx->nholes*sizeof(double));
+    idx->hhi=(double*)malloc(idx->nholes*sizeof(double));
+    if ( (idx->nvars > 0 && idx->col == NULL) ||
+         (ncols > 0 && idx->colvar == NULL) ||
+         (idx->nholes > 0 && (idx->hcol == NULL || idx->hlo == NULL || idx->hhi == NULL)) ) {
+        status = ERR_NOMEMORY;
+        goto TERMINATE;
+    }
+    idx->ncols=ncols;
+
+    for(j=0;j<ncols;j++) idx->colvar[j]=-1;
+    for(i=0;i<idx->nvars;i++){
+        idx->col[i]=col[i];
+        if (col[i] >= 0 && col[i] < ncols) idx->colvar[col[i]]=i;
+        else idx->col[i]=-1;
+        /* flat per-hole view for findviolation, holes of unmatched
+         * variables get an empty interval and never fire */
+        for(int h=idx->beg[i];h<idx->beg[i+1];h++){
+            if (idx->col[i] >= 0){
+                idx->hcol[h]=idx->col[i];
+                idx->hlo[h]=idx->lb[h]-1;
+                idx->hhi[h]=idx->ub[h]+1;
+            } else {
+                idx->hcol[h]=0;
+                idx->hlo[h]=HUGE_VAL;
+                idx->hhi[h]=-HUGE_VAL;
+            }
+        }
+    }
+
+TERMINATE:
+
+    if ( status ) {
+        FREEN (&idx->col);
+        FREEN (&idx->colvar);
+        FREEN (&idx->hcol);
+        FREEN (&idx->hlo);
+        FREEN (&idx->hhi);
+        idx->ncols=0;
+    }
+
+    return status;
+}/*END setholecols*/
+
+static unsigned int
+hashname (const char *name)
+{
+    /* FNV-1a */
+    unsigned int hash = 2166136261u;
+    for(;*name!='\0';name++){
+        hash ^= (unsigned char)*name;
+        hash *= 16777619u;
+    }
+    return hash;
+}/*END hashname*/
+
+int
+matchholecols (holeindex         *idx,
+               int               ncols,
+               const char *const *colname,
+               int               *nunmatched_p)
+{
+    int status=0;
+
+    int *table=NULL;
+    int *col=NULL;
+    unsigned int size=1;
+    unsigned int mask;
+    int nunmatched=0;
+    int i, j;
+
+    /* open addressing table of the hole variable names */
+    while ( size < 2*(unsigned int)idx->nvars ) size<<=1;
+    mask=size-1;
+
+    table=(int*)malloc(size*sizeof(int));
+    col=(int*)malloc(idx->nvars*sizeof(int));
+    if ( table == NULL ||
+         (idx->nvars > 0 && col == NULL) ) {
+        status = ERR_NOMEMORY;
+        goto TERMINATE;
+    }
+
+    for(unsigned int k=0;k<size;k++) table[k]=-1;
+    for(i=0;i<idx->nvars;i++){
+        col[i]=-1;
+        unsigned int k=hashname(holevarname(idx,i))&mask;
+        while ( table[k] >= 0 ) {
+            if (!strcmp(holevarname(idx,table[k]),holevarname(idx,i))) break;
+            k=(k+1)&mask;
+        }
+        /* duplicate names keep their first occurrence */
+        if ( table[k] < 0 ) table[k]=i;
+    }
+
+    for(j=0;j<ncols;j++){
+        unsigned int k=hashname(colname[j])&mask;
+        while ( table[k] >= 0 ) {
+            i=table[k];
+            if (!strcmp(holevarname(idx,i),colname[j])){
+                if (col[i] < 0) col[i]=j;
+                break;
+            }
+            k=(k+1)&mask;
+        }
+    }
+
+    for(i=0;i<idx->nvars;i++){
+        if (col[i] < 0) nunmatched++;
+    }
+
+    status = setholecols (idx, ncols, col);
+    if ( status ) goto TERMINATE;
+
+    if ( nunmatched_p != NULL ) *nunmatched_p=nunmatched;
+
+TERMINATE:
+
+    FREEN (&table);
+    FREEN (&col);
+
+    return status;
+}/*END matchholecols*/
+
+int
+reduceholes (holeindex     *idx,
+             double        *lb,
+             double        *ub,
+             holereduction *red)
+{
+    int ni = 0;
+    int nh = 0;
+    int hbeg = idx->beg[0];
+    int *col = NULL;
+
+    *red = holereduction();
+    col = (int*)malloc((idx->nvars+1)*sizeof(int));
+    if ( col == NULL ) return ERR_NOMEMORY;
+
+    /* compacts the index in place, variable ni and hole nh are the next
+     * ones written, which never overtake the ones read */
+    for(int i=0;i<idx->nvars;i++){
+        int hend = idx->beg[i+1];
+        int j = idx->col[i];
+        double l = idx->lbvar[i];
+        double u = idx->ubvar[i];
+        int first = nh;
+
+        /* the model bounds rule a matched variable, the hole-file
+         * bounds are only compared with them */
+        if ( j >= 0 ) {
+            if ( l != lb[j] || u != ub[j] ) red->bounddiff++;
+            l = lb[j];
+            u = ub[j];
+        }
+
+        /* merge adjacent holes, their excluded intervals overlap */
+        for(int h=hbeg;h<hend;h++){
+            if ( nh > first && idx->lb[h] <= idx->ub[nh-1] + 1 ) {
+                idx->ub[nh-1] = XMAX (idx->ub[nh-1], idx->ub[h]);
+                red->merged++;
+                continue;
+            }
+            idx->lb[nh] = idx->lb[h];
+            idx->ub[nh] = idx->ub[h];
+            nh++;
+        }
+        hbeg = hend;
+
+        /* move the bounds out of the holes, holes are disjoint now */
+        for(int h=first;h<nh;h++){
+            if ( idx->lb[h]-1 < l && l < idx->ub[h]+1 ) l = idx->ub[h]+1;
+        }
+        for(int h=nh-1;h>=first;h--){
+            if ( idx->lb[h]-1 < u && u < idx->ub[h]+1 ) u = idx->lb[h]-1;
+        }
+        if ( l > u ) red->infeasible++;
+
+        /* remove the holes that exclude nothing within [l,u] */
+        int k = first;
+        for(int h=first;h<nh;h++){
+            if ( l <= u && (idx->ub[h]+1 <= l || idx->lb[h]-1 >= u) ) {
+                red->clipped++;
+                continue;
+            }
+            idx->lb[k] = idx->lb[h];
+            idx->ub[k] = idx->ub[h];
+            k++;
+        }
+        nh = k;
+
+        if ( j >= 0 && l <= u ) {
+            if ( l > lb[j] ) lb[j] = l, red->tightened++;
+            if ( u < ub[j] ) ub[j] = u, red->tightened++;
+        }
+        if ( j >= 0 && nh == first ) {
+            red->dropped++;
+            continue;
+        }
+
+        idx->lbvar[ni] = l;
+        idx->ubvar[ni] = u;
+        idx->beg[ni] = first;
+        idx->namebeg[ni] = idx->namebeg[i];
+        col[ni] = j;
+        ni++;
+    }
+    idx->namebeg[ni] = idx->namebeg[idx->nvars];
+    idx->beg[ni] = nh;
+    idx->nvars = ni;
+    idx->nholes = nh;
+
+    int status = setholecols (idx, idx->ncols, col);
+    FREEN (&col);
+    return status;
+}/*END reduceholes*/
+
+void
+freeholeindex (holeindex *idx)
+{
+    /* a mapped index does not own its hole data */
+    if ( idx->map != NULL ) {
+        munmap (idx->map, idx->maplen);
+        idx->map=NULL;
+        idx->maplen=0;
+        idx->lbvar=NULL;
+        idx->ubvar=NULL;
+        idx->beg=NULL;
+        idx->lb=NULL;
+        idx->ub=NULL;
+        idx->namebeg=NULL;
+        idx->namestore=NULL;
+    }
+    FREEN (&idx->lbvar);
+    FREEN (&idx->ubvar);
+    FREEN (&idx->beg);
+    FREEN (&idx->lb);
+    FREEN (&idx->ub);
+    FREEN (&idx->namebeg);
+    FREEN (&idx->namestore);
+    FREEN (&idx->col);
+    FREEN (&idx->colvar);
+    FREEN (&idx->hcol);
+    FREEN (&idx->hlo);
+    FREEN (&idx->hhi);
+    idx->nvars=0;
+    idx->nholes=0;
+    idx->ncols=0;
+}/*END freeholeindex*/
+
+bool
+widesplit (const holeindex *idx,
+           int             i,
+           double          v,
+           bool            integer,
+           double          *pi0_p,
+           double          *pi1_p)
+{
+    double pi0, pi1;
+    int h = findhole (idx, i, v, EPSVIOL);
+
+    if ( h >= 0 ) {
+        pi0 = idx->lb[h]-1;
+        pi1 = idx->ub[h]+1;
+    } else if ( integer && v - floor (v) > EPSINT && ceil (v) - v > EPSINT ) {
+        pi0 = floor (v);
+        pi1 = ceil (v);
+    } else {
+        return false;
+    }
+
+    /* holes are sorted, so neighbouring holes are found in order */
+    while ( (h = findhole (idx, i, pi0, 0.5)) >= 0 ) pi0 = idx->lb[h]-1;
+    while ( (h = findhole (idx, i, pi1, 0.5)) >= 0 ) pi1 = idx->ub[h]+1;
+
+    *pi0_p = pi0;
+    *pi1_p = pi1;
+    return true;
+}/*END widesplit*/
+
+int
+holesegments (const holeindex *idx,
+              int             i,
+              double          lo,
+              double          up,
+              double          v,
+              int             maxparts,
+              double          *segl,
+              double          *segu)
+{
+    int nseg[2] = {0, 0};     /* segments below and above v */
+    int nparts[2] = {0, 0};
+
+    /* pass 0 counts the hole-free segments of [lo,up] on both sides of
+     * v, pass 1 groups each side into contiguous parts of about the
+     * same size */
+    for(int pass=0;pass<2;pass++){
+        int s[2] = {0, 0};
+        int lastp = -1;
+        double l = lo;
+        for(int h=idx->beg[i];h<=idx->beg[i+1] && l<=up;h++){
+            double u = ( h < idx->beg[i+1] ) ? XMIN (up, idx->lb[h]-1) : up;
+            if ( l <= u ) {
+                int side = ( l > v ) ? 1 : 0;
+                if ( pass == 1 ) {
+                    int p = (int)((long)s[side]*nparts[side]/nseg[side]) + (side == 1 ? nparts[0] : 0);
+                    if ( p != lastp ) segl[p] = l;
+                    segu[p] = u;
+                    lastp = p;
+                }
+                s[side]++;
+            }
+            if ( h < idx->beg[i+1] ) l = XMAX (l, idx->ub[h]+1);
+        }
+        if ( pass == 0 ) {
+            nseg[0] = s[0];
+            nseg[1] = s[1];
+            if ( nseg[0] + nseg[1] == 0 ) return 0;
+            if ( nseg[0] + nseg[1] <= maxparts ) {
+                nparts[0] = nseg[0];
+                nparts[1] = nseg[1];
+            } else if ( nseg[0] == 0 || nseg[1] == 0 ) {
+                nparts[0] = XMIN (nseg[0], maxparts);
+                nparts[1] = XMIN (nseg[1], maxparts);
+            } else {
+                /* both sides, in proportion to their segments */
+                nparts[0] = (int)((long)maxparts*nseg[0]/(nseg[0]+nseg[1]));
+                nparts[0] = XMIN (XMAX (nparts[0], 1), XMAX (maxparts-1, 1));
+                nparts[0] = XMIN (nparts[0], nseg[0]);
+                nparts[1] = XMIN (XMAX (maxparts - nparts[0], 1), nseg[1]);
+            }
+        }
+    }
+    return nparts[0] + nparts[1];
+}/*END holesegments*/
+
+bool
+snapholebounds (const holeindex *idx,
+                int             i,
+                double          *lo_p,
+                double          *up_p)
+{
+    double lo = *lo_p;
+    double up = *up_p;
+    int h;
+
+    while ( (h = findhole (idx, i, lo, 0.0)) >= 0 ) lo = idx->ub[h]+1;
+    while ( (h = findhole (idx, i, up, 0.0)) >= 0 ) up = idx->lb[h]-1;
+
+    *lo_p = lo;
+    *up_p = up;
+    return lo <= up + EPSRHS;
+}/*END snapholebounds*/
+
+static int
+findviolation_scalar (const holeindex *idx,
+                      const double    *x,
+                      double          tol,
+                      int             h)
+{
+    const int *hcol = idx->hcol;
+    const double *hlo = idx->hlo;
+    const double *hhi = idx->hhi;
+
+    for(;h<idx->nholes;h++){
+        double v = x[hcol[h]];
+        if (v > hlo[h] + tol && v < hhi[h] - tol) return h;
+    }
+    return -1;
+}/*END findviolation_scalar*/
+
+#ifdef HOLES_AVX2
+__attribute__((target("avx2")))
+static int
+findviolation_avx2 (const holeindex *idx,
+                    const double    *x,
+                    double          tol)
+{
+    const int *hcol = idx->hcol;
+    const double *hlo = idx->hlo;
+    const double *hhi = idx->hhi;
+    const __m256d vtol = _mm256_set1_pd(tol);
+    const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    int h = 0;
+
+    for(;h+4<=idx->nholes;h+=4){
+        __m128i vcol = _mm_loadu_si128((const __m128i*)(hcol+h));
+        __m256d v = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), x, vcol, all, 8);
+        __m256d lo = _mm256_add_pd(_mm256_loadu_pd(hlo+h), vtol);
+        __m256d hi = _mm256_sub_pd(_mm256_loadu_pd(hhi+h), vtol);
+        __m256d in = _mm256_and_pd(_mm256_cmp_pd(v, lo, _CMP_GT_OQ),
+                                   _mm256_cmp_pd(v, hi, _CMP_LT_OQ));
+        int mask = _mm256_movemask_pd(in);
+        if (mask) return h + __builtin_ctz(mask);
+    }
+    return findviolation_scalar (idx, x, tol, h);
+}/*END findviolation_avx2*/
+#endif
+
+int
+findviolation (const holeindex *idx,
+               const double    *x,
+               double          tol,
+               int             *var_p)
+{
+    int h;
+
+#ifdef HOLES_AVX2
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    if (has_avx2) h = findviolation_avx2 (idx, x, tol);
+    else h = findviolation_scalar (idx, x, tol, 0);
+#else
+    h = findviolation_scalar (idx, x, tol, 0);
+#endif
+
+    if (h >= 0 && var_p != NULL){
+        /* variable owning hole h: last i with beg[i] <= h */
+        int lo = 0;
+        int hi = idx->nvars-1;
+        while ( lo < hi ) {
+            int mid = lo + (hi-lo+1)/2;
+            if ( idx->beg[mid] <= h ) lo = mid;
+            else hi = mid-1;
+        }
+        *var_p = lo;
+    }
+    return h;
+}/*END findviolation*/
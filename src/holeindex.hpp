@@ -0,0 +1,206 @@
+// Authors:	Sven Wiese
+//-----------------------------------------------------
+#ifndef holeindex_H
+#define holeindex_H
+
+#include <cstddef>
+
+/* Contiguous index of the hole data of all variables with holes.
+ * The holes of variable i are lb[beg[i]..beg[i+1]-1] / ub[...],
+ * sorted by lower bound and non-overlapping. A hole [l,u] excludes
+ * the integer values l,...,u, i.e., the open interval (l-1,u+1). */
+struct holeindex {
+
+   holeindex() :	nvars(0),
+			nholes(0),
+			lbvar(NULL),
+			ubvar(NULL),
+			beg(NULL),
+			lb(NULL),
+			ub(NULL),
+			namebeg(NULL),
+			namestore(NULL),
+			ncols(0),
+			col(NULL),
+			colvar(NULL),
+			hcol(NULL),
+			hlo(NULL),
+			hhi(NULL),
+			map(NULL),
+			maplen(0){}
+
+   int nvars;
+   int nholes;
+   double *lbvar;     /* [nvars] variable bounds given in the hole file */
+   double *ubvar;
+   int *beg;          /* [nvars+1] offsets into lb/ub */
+   double *lb;        /* [nholes] packed hole bounds */
+   double *ub;
+   int *namebeg;      /* [nvars+1] offsets into namestore */
+   char *namestore;   /* '\0'-terminated variable names */
+   int ncols;
+   int *col;          /* [nvars] column of variable i, -1 if unmatched */
+   int *colvar;       /* [ncols] variable of column j, -1 if no holes */
+   int *hcol;         /* [nholes] column of hole h (0 if unmatched) */
+   double *hlo;       /* [nholes] lb-1, +inf if the column is unmatched */
+   double *hhi;       /* [nholes] ub+1, -inf if the column is unmatched */
+   void *map;         /* if set, lbvar..namestore point into this mapping */
+   size_t maplen;
+};
+
+int
+buildholeindex (int           nvarswithholes,
+                const double  *lbvarswithholes,
+                const double  *ubvarswithholes,
+                const int     *nholesvarswithholes,
+                char          **namevarswithholes,
+                double        **lbholes,
+                double        **ubholes,
+                holeindex     *idx);
+
+/* Sorts the n holes lb[0..n-1] / ub[0..n-1] of one variable in place,
+ * drops empty holes and merges overlapping ones. Returns the new
+ * number of holes. */
+int
+normalizeholes (double *lb,
+                double *ub,
+                int    n);
+
+int
+setholecols (holeindex *idx,
+             int       ncols,
+             const int *col);
+
+/* Matches the variable names of the index against the column names
+ * colname[0..ncols-1] in one pass and installs the result with
+ * setholecols. Variables without a column are left unmatched
+ * (col[i] == -1) and counted in *nunmatched_p. */
+int
+matchholecols (holeindex         *idx,
+               int               ncols,
+               const char *const *colname,
+               int               *nunmatched_p);
+
+void
+freeholeindex (holeindex *idx);
+
+/* Statistics of reduceholes. */
+struct holereduction {
+
+   holereduction() :	merged(0),
+			clipped(0),
+			tightened(0),
+			dropped(0),
+			bounddiff(0),
+			infeasible(0){}
+
+   int merged;        /* adjacent holes merged */
+   int clipped;       /* holes outside the bounds removed */
+   int tightened;     /* column bounds moved out of a hole */
+   int dropped;       /* variables left without holes */
+   int bounddiff;     /* variables whose hole-file bounds differ from the column bounds */
+   int infeasible;    /* variables without hole-free values */
+};
+
+/* Static presolve of the holes against the column bounds lb/ub of the
+ * model (indexed by column, requires setholecols): adjacent holes are
+ * merged, bounds that lie in a hole are moved to its edge, holes
+ * outside the bounds are removed, and matched variables left without
+ * holes are dropped from the index. The hole-file bounds of a matched
+ * variable are replaced by its column bounds, differences are only
+ * counted; lb/ub are tightened in place. */
+int
+reduceholes (holeindex     *idx,
+             double        *lb,
+             double        *ub,
+             holereduction *red);
+
+/* Wide split disjunction x <= *pi0_p or x >= *pi1_p of variable i
+ * that cuts off the value v: the hole containing v, or, for an
+ * integer variable with fractional v, floor(v)/ceil(v). Either side
+ * is widened across holes it runs into. Returns false if v is
+ * neither in a hole nor fractional. */
+bool
+widesplit (const holeindex *idx,
+           int             i,
+           double          v,
+           bool            integer,
+           double          *pi0_p,
+           double          *pi1_p);
+
+/* Splits the domain [lo,up] of variable i into its hole-free segments
+ * and groups neighbouring segments into at most maxparts parts, whose
+ * bounds are stored in segl/segu. The segments below v and the ones
+ * above v are grouped separately, so no part spans the hole v lies in;
+ * both sides get a part even if maxparts is 1. A v outside [lo,up]
+ * gives a plain grouping. Returns the number of parts, 0 if the domain
+ * lies in the holes entirely. */
+int
+holesegments (const holeindex *idx,
+              int             i,
+              double          lo,
+              double          up,
+              double          v,
+              int             maxparts,
+              double          *segl,
+              double          *segu);
+
+/* Moves the bounds *lo_p and *up_p of variable i out of the holes they
+ * lie in, passing adjacent holes one after the other. Returns false
+ * if the domain lies in the holes entirely. */
+bool
+snapholebounds (const holeindex *idx,
+                int             i,
+                double          *lo_p,
+                double          *up_p);
+
+/* Checks a full solution vector x against all holes at once and
+ * returns the first hole h with hlo[h]+tol < x[hcol[h]] < hhi[h]-tol,
+ * or -1 if x is hole-free. The variable of h is stored in *var_p.
+ * Uses AVX2 when the CPU supports it. Requires setholecols. */
+int
+findviolation (const holeindex *idx,
+               const double    *x,
+               double          tol,
+               int             *var_p);
+
+inline const char *
+holevarname (const holeindex *idx,
+             int             i)
+{
+    return idx->namestore + idx->namebeg[i];
+}
+
+/* Returns the packed position h of the hole of variable i with
+ * lb[h]-1+tol < v < ub[h]+1-tol, or -1 if v is in no hole. */
+inline int
+findhole (const holeindex *idx,
+          int             i,
+          double          v,
+          double          tol)
+{
+    int lo = idx->beg[i];
+    int hi = idx->beg[i+1];
+    /* first hole whose upper end lies beyond v */
+    while ( lo < hi ) {
+        int mid = lo + (hi-lo)/2;
+        if ( idx->ub[mid] + 1 - tol > v ) hi = mid;
+        else lo = mid+1;
+    }
+    if ( lo < idx->beg[i+1] && idx->lb[lo] - 1 + tol < v ) return lo;
+    return -1;
+}
+
+/* Same as findhole, but for column j of the model. */
+inline int
+findholecol (const holeindex *idx,
+             int             j,
+             double          v,
+             double          tol)
+{
+    int i = idx->colvar[j];
+    if ( i < 0 ) return -1;
+    return findhole (idx, i, v, tol);
+}
+
+#endif
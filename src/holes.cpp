@@ -3,8 +3,15 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "holes.hpp"
+#include "holeindex.hpp"
 #include "utils.hpp"
 
 int
@@ -154,3 +161,483 @@ TERMINATE:
     
     return status;
 }/*END readholes*/
+
+
+/* Hand-written scanner over the mapped hole file. Tokens follow the
+ * rules of fscanf's %s and %d. */
+struct holescanner {
+    const char *p;
+    const char *end;
+    const char *linebeg;
+    int line;
+};
+
+static inline void
+skipspace (holescanner *sc)
+{
+    while ( sc->p < sc->end ) {
+        char c = *sc->p;
+        if ( c == '\n' ) {
+            sc->line++;
+            sc->linebeg = sc->p+1;
+        } else if ( c != ' ' && c != '\t' && c != '\r' &&
+                    c != '\v' && c != '\f' ) {
+            break;
+        }
+        sc->p++;
+    }
+}
+
+static inline bool
+scanint (holescanner *sc,
+         int         *v)
+{
+    const char *p;
+    bool neg = false;
+    long long val = 0;
+
+    skipspace (sc);
+    p = sc->p;
+    if ( p < sc->end && (*p == '-' || *p == '+') ) {
+        neg = (*p == '-');
+        p++;
+    }
+    if ( p == sc->end || *p < '0' || *p > '9' ) return false;
+    while ( p < sc->end && *p >= '0' && *p <= '9' ) {
+        if ( val <= 2147483648LL ) val = 10*val + (*p - '0');
+        p++;
+    }
+    if ( neg ) val = -val;
+    if ( val > 2147483647LL ) val = 2147483647LL;
+    if ( val < -2147483647LL-1 ) val = -2147483647LL-1;
+    *v = (int)val;
+    sc->p = p;
+    return true;
+}
+
+static inline bool
+scanname (holescanner *sc,
+          const char  **name_p,
+          int         *len_p)
+{
+    const char *p;
+
+    skipspace (sc);
+    p = sc->p;
+    while ( p < sc->end && *p != ' ' && *p != '\n' && *p != '\t' &&
+            *p != '\r' && *p != '\v' && *p != '\f' ) p++;
+    if ( p == sc->p ) return false;
+    *name_p = sc->p;
+    *len_p = (int)(p - sc->p);
+    sc->p = p;
+    return true;
+}
+
+static int
+scanerror (const char  *filename,
+           holescanner *sc,
+           const char  *what)
+{
+    skipspace (sc);
+    if ( sc->p == sc->end )
+        printf ("ERROR: %s:%d:%d: expected %s, found end of file\n",
+                filename, sc->line, (int)(sc->p - sc->linebeg)+1, what);
+    else
+        printf ("ERROR: %s:%d:%d: expected %s\n",
+                filename, sc->line, (int)(sc->p - sc->linebeg)+1, what);
+    return ERR_BADFILEFORMAT;
+}
+
+/* grow a malloc'ed array to hold at least need elements */
+template <typename T>
+static bool
+growarray (T   **arr,
+           int *cap,
+           int need)
+{
+    if ( need <= *cap ) return true;
+    int newcap = XMAX(2*(*cap), need);
+    T *tmp = (T*)realloc(*arr, newcap*sizeof(T));
+    if ( tmp == NULL ) return false;
+    *arr = tmp;
+    *cap = newcap;
+    return true;
+}
+
+/* grow the packed hole arrays of idx to hold at least need holes */
+static bool
+growholes (holeindex *idx,
+           int       *cap,
+           int       need)
+{
+    int ubcap = *cap;
+    return growarray (&idx->lb, cap, need) &&
+           growarray (&idx->ub, &ubcap, need);
+}
+
+int
+readholes_mmap (const char *filename,
+                holeindex  *idx)
+{
+    int status=0;
+
+    int fd = -1;
+    struct stat st;
+    void *map = MAP_FAILED;
+    size_t maplen = 0;
+
+    holescanner sc;
+    int nvarswithholes=0;
+    int holecap=0;
+    int namecap=0;
+    int nholes=0;
+    int namelen=0;
+    int i, j;
+
+    freeholeindex (idx);
+
+    fd = open (filename, O_RDONLY);
+    if ( fd < 0 || fstat (fd, &st) != 0 ) {
+        printf ("ERROR1 %s\n", filename);
+        status = ERR_BADARGUMENT;
+        goto TERMINATE;
+    }
+
+    maplen = (size_t)st.st_size;
+    if ( maplen > 0 ) {
+        map = mmap (NULL, maplen, PROT_READ, MAP_PRIVATE, fd, 0);
+        if ( map == MAP_FAILED ) {
+            printf ("ERROR1 %s\n", filename);
+            status = ERR_BADARGUMENT;
+            goto TERMINATE;
+        }
+        madvise (map, maplen, MADV_SEQUENTIAL);
+    }
+
+    sc.p = (map == MAP_FAILED) ? NULL : (const char*)map;
+    sc.end = sc.p + maplen;
+    sc.linebeg = sc.p;
+    sc.line = 1;
+
+    /*read number of variables with holes*/
+    if ( !scanint (&sc, &nvarswithholes) || nvarswithholes < 0 ) {
+        status = scanerror (filename, &sc, "number of variables");
+        goto TERMINATE;
+    }
+
+    /*Allocate memory*/
+    idx->lbvar=(double*)malloc(nvarswithholes*sizeof(double));
+    idx->ubvar=(double*)malloc(nvarswithholes*sizeof(double));
+    idx->beg=(int*)malloc((nvarswithholes+1)*sizeof(int));
+    idx->namebeg=(int*)malloc((nvarswithholes+1)*sizeof(int));
+    if ( (nvarswithholes > 0 && (idx->lbvar == NULL || idx->ubvar == NULL)) ||
+         idx->beg == NULL ||
+         idx->namebeg == NULL ||
+         !growholes (idx, &holecap, 4*nvarswithholes+1) ||
+         !growarray (&idx->namestore, &namecap, 8*nvarswithholes+1) ) {
+        status = ERR_NOMEMORY;
+        goto TERMINATE;
+    }
+    idx->beg[0]=0;
+    idx->namebeg[0]=0;
+
+    /*read hole information row by row*/
+    for(i=0;i<nvarswithholes;i++){
+        const char *name;
+        int len, coef1, coef2, nh;
+
+        if ( !scanname (&sc, &name, &len) ) {
+            status = scanerror (filename, &sc, "variable name");
+            goto TERMINATE;
+        }
+        if ( !growarray (&idx->namestore, &namecap, namelen+len+1) ) {
+            status = ERR_NOMEMORY;
+            goto TERMINATE;
+        }
+        memcpy (idx->namestore+namelen, name, len);
+        idx->namestore[namelen+len]='\0';
+        namelen+=len+1;
+        idx->namebeg[i+1]=namelen;
+
+        if ( !scanint (&sc, &coef1) ) {
+            status = scanerror (filename, &sc, "variable lower bound");
+            goto TERMINATE;
+        }
+        if ( !scanint (&sc, &coef2) ) {
+            status = scanerror (filename, &sc, "variable upper bound");
+            goto TERMINATE;
+        }
+        if ( !scanint (&sc, &nh) || nh < 0 ) {
+            status = scanerror (filename, &sc, "number of holes");
+            goto TERMINATE;
+        }
+        idx->lbvar[i]=(double)coef1;
+        idx->ubvar[i]=(double)coef2;
+
+        if ( !growholes (idx, &holecap, nholes+nh) ) {
+            status = ERR_NOMEMORY;
+            goto TERMINATE;
+        }
+        for(j=0;j<nh;j++){
+            if ( !scanint (&sc, &coef1) ) {
+                status = scanerror (filename, &sc, "hole lower bound");
+                goto TERMINATE;
+            }
+            if ( !scanint (&sc, &coef2) ) {
+                status = scanerror (filename, &sc, "hole upper bound");
+                goto TERMINATE;
+            }
+            idx->lb[nholes+j]=(double)coef1;
+            idx->ub[nholes+j]=(double)coef2;
+        }
+        nholes+=normalizeholes (idx->lb+nholes, idx->ub+nholes, nh);
+        idx->beg[i+1]=nholes;
+    }
+    idx->nvars=nvarswithholes;
+    idx->nholes=nholes;
+
+TERMINATE:
+
+    if ( map != MAP_FAILED )
+        munmap (map, maplen);
+    if ( fd >= 0 )
+        close (fd);
+
+    if ( status ) freeholeindex (idx);
+
+    return status;
+}/*END readholes_mmap*/
+
+
+struct holebinheader {
+    char magic[8];
+    unsigned int version;
+    unsigned int headersize;
+    long long nvars;
+    long long nholes;
+    long long namelen;
+    unsigned long long payloadsize;
+    unsigned long long checksum;
+    long long srcsize;     /* text file the index was read from, -1 if none */
+    long long srcmtime;
+};
+
+static inline size_t
+pad8 (size_t n)
+{
+    return (n + 7) & ~(size_t)7;
+}
+
+/* 64-bit FNV-1a over 8-byte words, len is a multiple of 8 */
+static unsigned long long
+holebinchecksum (const char *data,
+                 size_t     len)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    for(size_t k=0;k<len;k+=8){
+        unsigned long long w;
+        memcpy (&w, data+k, 8);
+        hash ^= w;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/* byte offsets of the sections in the payload */
+static void
+holebinlayout (long long nvars,
+               long long nholes,
+               long long namelen,
+               size_t    *off)
+{
+    off[0] = 0;                                          /* lbvar */
+    off[1] = off[0] + pad8 (nvars*sizeof(double));       /* ubvar */
+    off[2] = off[1] + pad8 (nvars*sizeof(double));       /* lb */
+    off[3] = off[2] + pad8 (nholes*sizeof(double));      /* ub */
+    off[4] = off[3] + pad8 (nholes*sizeof(double));      /* beg */
+    off[5] = off[4] + pad8 ((nvars+1)*sizeof(int));      /* namebeg */
+    off[6] = off[5] + pad8 ((nvars+1)*sizeof(int));      /* namestore */
+    off[7] = off[6] + pad8 (namelen);                    /* end */
+}
+
+int
+writeholes_bin (const char      *filename,
+                const holeindex *idx,
+                const char      *srcname)
+{
+    int status=0;
+
+    FILE *fout = NULL;
+    char *payload = NULL;
+    holebinheader hdr;
+    size_t off[8];
+    long long namelen = idx->namebeg[idx->nvars];
+
+    holebinlayout (idx->nvars, idx->nholes, namelen, off);
+
+    payload = (char*)calloc(off[7]+1, sizeof(char));
+    if ( payload == NULL ) {
+        status = ERR_NOMEMORY;
+        goto TERMINATE;
+    }
+    memcpy (payload+off[0], idx->lbvar, idx->nvars*sizeof(double));
+    memcpy (payload+off[1], idx->ubvar, idx->nvars*sizeof(double));
+    memcpy (payload+off[2], idx->lb, idx->nholes*sizeof(double));
+    memcpy (payload+off[3], idx->ub, idx->nholes*sizeof(double));
+    memcpy (payload+off[4], idx->beg, (idx->nvars+1)*sizeof(int));
+    memcpy (payload+off[5], idx->namebeg, (idx->nvars+1)*sizeof(int));
+    memcpy (payload+off[6], idx->namestore, namelen);
+
+    memset (&hdr, 0, sizeof(hdr));
+    memcpy (hdr.magic, HOLEBIN_MAGIC, 8);
+    hdr.version = HOLEBIN_VERSION;
+    hdr.headersize = sizeof(hdr);
+    hdr.nvars = idx->nvars;
+    hdr.nholes = idx->nholes;
+    hdr.namelen = namelen;
+    hdr.payloadsize = off[7];
+    hdr.checksum = holebinchecksum (payload, off[7]);
+    hdr.srcsize = -1;
+    hdr.srcmtime = 0;
+    if ( srcname != NULL ) {
+        struct stat st;
+        if ( stat (srcname, &st) == 0 ) {
+            hdr.srcsize = (long long)st.st_size;
+            hdr.srcmtime = (long long)st.st_mtime;
+        }
+    }
+
+    fout = fopen (filename, "wb");
+    if ( fout == NULL ) {
+        printf ("ERROR1 %s\n", filename);
+        status = ERR_OPENFILE;
+        goto TERMINATE;
+    }
+    if ( fwrite (&hdr, sizeof(hdr), 1, fout) != 1 ||
+         fwrite (payload, 1, off[7], fout) != off[7] ) {
+        status = ERR_OPENFILE;
+        goto TERMINATE;
+    }
+
+TERMINATE:
+
+    if ( fout != NULL && fclose (fout) != 0 && !status )
+        status = ERR_OPENFILE;
+
+    FREEN (&payload);
+
+    return status;
+}/*END writeholes_bin*/
+
+bool
+holebinmatches (const char *filename,
+                const char *srcname)
+{
+    holebinheader hdr;
+    struct stat st;
+    bool matches = false;
+
+    if ( stat (srcname, &st) != 0 ) return true;
+    int fd = open (filename, O_RDONLY);
+    if ( fd < 0 ) return false;
+    if ( read (fd, &hdr, sizeof(hdr)) == (ssize_t)sizeof(hdr) &&
+         !memcmp (hdr.magic, HOLEBIN_MAGIC, 8) &&
+         hdr.version == HOLEBIN_VERSION &&
+         hdr.headersize == sizeof(holebinheader) ) {
+        matches = hdr.srcsize == (long long)st.st_size && hdr.srcmtime == (long long)st.st_mtime;
+    }
+    close (fd);
+    return matches;
+}/*END holebinmatches*/
+
+int
+readholes_bin (const char *filename,
+               holeindex  *idx)
+{
+    int status=0;
+
+    int fd = -1;
+    struct stat st;
+    void *map = MAP_FAILED;
+    size_t maplen = 0;
+    const holebinheader *hdr;
+    char *payload;
+    size_t off[8];
+
+    freeholeindex (idx);
+
+    fd = open (filename, O_RDONLY);
+    if ( fd < 0 || fstat (fd, &st) != 0 ) {
+        printf ("ERROR1 %s\n", filename);
+        status = ERR_BADARGUMENT;
+        goto TERMINATE;
+    }
+
+    maplen = (size_t)st.st_size;
+    if ( maplen < sizeof(holebinheader) ) {
+        status = ERR_BADFILEFORMAT;
+        goto TERMINATE;
+    }
+    /* private writable mapping: pages are shared with the page cache
+     * and only copied if the hole data is modified later on */
+    map = mmap (NULL, maplen, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if ( map == MAP_FAILED ) {
+        printf ("ERROR1 %s\n", filename);
+        status = ERR_BADARGUMENT;
+        goto TERMINATE;
+    }
+
+    hdr = (const holebinheader*)map;
+    if ( memcmp (hdr->magic, HOLEBIN_MAGIC, 8) ||
+         hdr->version != HOLEBIN_VERSION ||
+         hdr->headersize != sizeof(holebinheader) ||
+         hdr->nvars < 0 || hdr->nvars > 2147483646LL ||
+         hdr->nholes < 0 || hdr->nholes > 2147483647LL ||
+         hdr->namelen < 0 || hdr->namelen > 2147483647LL ) {
+        status = ERR_BADFILEFORMAT;
+        goto TERMINATE;
+    }
+    holebinlayout (hdr->nvars, hdr->nholes, hdr->namelen, off);
+    if ( hdr->payloadsize != off[7] ||
+         maplen != sizeof(holebinheader) + off[7] ) {
+        status = ERR_BADFILEFORMAT;
+        goto TERMINATE;
+    }
+
+    payload = (char*)map + sizeof(holebinheader);
+    if ( holebinchecksum (payload, off[7]) != hdr->checksum ) {
+        status = ERR_BADFILEFORMAT;
+        goto TERMINATE;
+    }
+
+    idx->nvars = (int)hdr->nvars;
+    idx->nholes = (int)hdr->nholes;
+    idx->lbvar = (double*)(payload+off[0]);
+    idx->ubvar = (double*)(payload+off[1]);
+    idx->lb = (double*)(payload+off[2]);
+    idx->ub = (double*)(payload+off[3]);
+    idx->beg = (int*)(payload+off[4]);
+    idx->namebeg = (int*)(payload+off[5]);
+    idx->namestore = (char*)(payload+off[6]);
+    idx->map = map;
+    idx->maplen = maplen;
+    map = MAP_FAILED;
+
+    if ( idx->beg[0] != 0 || idx->beg[idx->nvars] != idx->nholes ||
+         idx->namebeg[0] != 0 || idx->namebeg[idx->nvars] != hdr->namelen ||
+         (hdr->namelen > 0 && idx->namestore[hdr->namelen-1] != '\0') ) {
+        status = ERR_BADFILEFORMAT;
+        goto TERMINATE;
+    }
+
+TERMINATE:
+
+    if ( map != MAP_FAILED )
+        munmap (map, maplen);
+    if ( fd >= 0 )
+        close (fd);
+
+    if ( status ) freeholeindex (idx);
+
+    return status;
+}/*END readholes_bin*/
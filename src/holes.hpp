@@ -13,5 +13,40 @@ readholes (const char *filename,
            double     ***lbholes_p,
            double     ***ubholes_p);
 
+struct holeindex;
+
+/* Reads the hole file through mmap straight into a hole index.
+ * Same text format as readholes; format errors are reported with
+ * line and column. */
+int
+readholes_mmap (const char *filename,
+                holeindex  *idx);
+
+/* Binary hole format: a header followed by the packed arrays of a
+ * hole index (lbvar, ubvar, lb, ub, beg, namebeg, namestore), each
+ * padded to 8 bytes and covered by a 64-bit FNV-1a checksum. The
+ * header records size and modification time of the text file the
+ * index was read from, if any. */
+#define HOLEBIN_MAGIC    "WSBHOLES"
+#define HOLEBIN_VERSION  2
+
+int
+writeholes_bin (const char      *filename,
+                const holeindex *idx,
+                const char      *srcname);
+
+/* True if filename is a binary hole file of this version that was
+ * written from srcname as it is now (same size and modification time),
+ * or srcname does not exist. */
+bool
+holebinmatches (const char *filename,
+                const char *srcname);
+
+/* Maps a binary hole file and uses it in place. Returns
+ * ERR_BADFILEFORMAT if the header or the checksum does not match. */
+int
+readholes_bin (const char *filename,
+               holeindex  *idx);
+
 #endif
 
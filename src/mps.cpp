@@ -0,0 +1,291 @@
+// Authors:	Sven Wiese
+//-----------------------------------------------------
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+
+#include "mps.hpp"
+#include "utils.hpp"
+
+#define MPS_MAXTOKENS  8
+
+enum mpssection {
+    SEC_NONE,
+    SEC_NAME,
+    SEC_OBJSENSE,
+    SEC_ROWS,
+    SEC_COLUMNS,
+    SEC_RHS,
+    SEC_RANGES,
+    SEC_BOUNDS,
+    SEC_END
+};
+
+/* splits line at white space, returns the number of tokens */
+static int
+splitline (char *line,
+           char **tok)
+{
+    int ntok = 0;
+    char *s = line;
+    while ( ntok < MPS_MAXTOKENS ) {
+        while ( *s == ' ' || *s == '\t' || *s == '\r' || *s == '\n' ) s++;
+        if ( *s == '\0' ) break;
+        tok[ntok++] = s;
+        while ( *s != '\0' && *s != ' ' && *s != '\t' && *s != '\r' && *s != '\n' ) s++;
+        if ( *s == '\0' ) break;
+        *s++ = '\0';
+    }
+    return ntok;
+}/*END splitline*/
+
+static bool
+parsenumber (const char *tok,
+             double     *v_p)
+{
+    char *end = NULL;
+    *v_p = strtod (tok, &end);
+    return end != tok && *end == '\0';
+}/*END parsenumber*/
+
+int
+readmps (const char *filename,
+         mpsproblem *prob)
+{
+    int status = 0;
+    FILE *fin = NULL;
+    char *line = NULL;
+    size_t cap = 0;
+    long lineno = 0;
+    char *tok[MPS_MAXTOKENS];
+    mpssection sec = SEC_NONE;
+    bool integer = false;
+    std::string objname;
+    std::vector<char> sense;
+    std::vector<double> rhs;
+    std::vector<double> rng;
+    std::vector<bool> hasrng;
+    std::unordered_map<std::string,int> rowind;    /* -1: objective, -2: other free row */
+    std::unordered_map<std::string,int> colind;
+
+    *prob = mpsproblem();
+
+    fin = fopen (filename, "r");
+    if ( fin == NULL ) {
+        printf ("ERROR: cannot open %s\n", filename);
+        status = ERR_OPENFILE;
+        goto TERMINATE;
+    }
+
+    while ( sec != SEC_END && getline (&line, &cap, fin) >= 0 ) {
+        lineno++;
+        if ( line[0] == '*' ) continue;
+        bool header = line[0] != ' ' && line[0] != '\t';
+        int ntok = splitline (line, tok);
+        if ( ntok == 0 ) continue;
+
+        if ( header ) {
+            if ( !strcmp (tok[0], "NAME") ) {
+                sec = SEC_NAME;
+                if ( ntok > 1 ) prob->name = tok[1];
+            } else if ( !strcmp (tok[0], "OBJSENSE") ) {
+                sec = SEC_OBJSENSE;
+                if ( ntok > 1 ) prob->objsen = strncmp (tok[1], "MAX", 3) ? 1 : -1;
+            } else if ( !strcmp (tok[0], "ROWS") ) {
+                sec = SEC_ROWS;
+            } else if ( !strcmp (tok[0], "COLUMNS") ) {
+                sec = SEC_COLUMNS;
+            } else if ( !strcmp (tok[0], "RHS") ) {
+                sec = SEC_RHS;
+            } else if ( !strcmp (tok[0], "RANGES") ) {
+                sec = SEC_RANGES;
+            } else if ( !strcmp (tok[0], "BOUNDS") ) {
+                sec = SEC_BOUNDS;
+            } else if ( !strcmp (tok[0], "ENDATA") ) {
+                sec = SEC_END;
+            } else {
+                printf ("ERROR: %s:%ld: unknown section %s\n", filename, lineno, tok[0]);
+                status = ERR_BADFILEFORMAT;
+                goto TERMINATE;
+            }
+            continue;
+        }
+
+        switch ( sec ) {
+        case SEC_OBJSENSE:
+            prob->objsen = strncmp (tok[0], "MAX", 3) ? 1 : -1;
+            break;
+        case SEC_ROWS: {
+            if ( ntok < 2 || strlen (tok[0]) != 1 || strchr ("NLGE", tok[0][0]) == NULL ) {
+                printf ("ERROR: %s:%ld: bad row\n", filename, lineno);
+                status = ERR_BADFILEFORMAT;
+                goto TERMINATE;
+            }
+            if ( tok[0][0] == 'N' ) {
+                rowind[tok[1]] = objname.empty () ? -1 : -2;
+                if ( objname.empty () ) objname = tok[1];
+                break;
+            }
+            rowind[tok[1]] = prob->nrows++;
+            prob->rowname.push_back (tok[1]);
+            sense.push_back (tok[0][0]);
+            rhs.push_back (0.0);
+            rng.push_back (0.0);
+            hasrng.push_back (false);
+            break;
+        }
+        case SEC_COLUMNS: {
+            if ( ntok >= 3 && !strcmp (tok[1], "'MARKER'") ) {
+                if ( !strcmp (tok[2], "'INTORG'") ) integer = true;
+                else if ( !strcmp (tok[2], "'INTEND'") ) integer = false;
+                break;
+            }
+            if ( ntok != 3 && ntok != 5 ) {
+                printf ("ERROR: %s:%ld: bad column entry\n", filename, lineno);
+                status = ERR_BADFILEFORMAT;
+                goto TERMINATE;
+            }
+            if ( prob->ncols == 0 || prob->colname.back () != tok[0] ) {
+                if ( colind.count (tok[0]) ) {
+                    printf ("ERROR: %s:%ld: entries of column %s are not contiguous\n", filename, lineno, tok[0]);
+                    status = ERR_BADFILEFORMAT;
+                    goto TERMINATE;
+                }
+                colind[tok[0]] = prob->ncols++;
+                prob->colname.push_back (tok[0]);
+                prob->matbeg.push_back ((int)prob->matind.size ());
+                prob->obj.push_back (0.0);
+                prob->lb.push_back (0.0);
+                prob->ub.push_back (HUGE_VAL);
+                prob->ctype.push_back (integer ? 'I' : 'C');
+            }
+            for(int k=1;k+1<ntok;k+=2){
+                double v;
+                std::unordered_map<std::string,int>::iterator it = rowind.find (tok[k]);
+                if ( it == rowind.end () || !parsenumber (tok[k+1], &v) ) {
+                    printf ("ERROR: %s:%ld: bad entry %s %s\n", filename, lineno, tok[k], tok[k+1]);
+                    status = ERR_BADFILEFORMAT;
+                    goto TERMINATE;
+                }
+                if ( it->second == -1 ) {
+                    prob->obj.back () = v;
+                } else if ( it->second >= 0 && v != 0 ) {
+                    prob->matind.push_back (it->second);
+                    prob->matval.push_back (v);
+                }
+            }
+            break;
+        }
+        case SEC_RHS:
+        case SEC_RANGES: {
+            /* the name of the vector is optional */
+            int first = (ntok % 2 == 1) ? 1 : 0;
+            for(int k=first;k+1<ntok;k+=2){
+                double v;
+                std::unordered_map<std::string,int>::iterator it = rowind.find (tok[k]);
+                if ( it == rowind.end () || !parsenumber (tok[k+1], &v) ) {
+                    printf ("ERROR: %s:%ld: bad entry %s %s\n", filename, lineno, tok[k], tok[k+1]);
+                    status = ERR_BADFILEFORMAT;
+                    goto TERMINATE;
+                }
+                if ( it->second == -1 ) {
+                    if ( sec == SEC_RHS ) prob->objoffset = -v;
+                } else if ( it->second >= 0 ) {
+                    if ( sec == SEC_RHS ) {
+                        rhs[it->second] = v;
+                    } else {
+                        rng[it->second] = v;
+                        hasrng[it->second] = true;
+                    }
+                }
+            }
+            break;
+        }
+        case SEC_BOUNDS: {
+            const char *type = tok[0];
+            bool novalue = !strcmp (type, "FR") || !strcmp (type, "MI") ||
+                           !strcmp (type, "PL") || !strcmp (type, "BV");
+            /* the name of the bound set is optional */
+            int c = (ntok >= (novalue ? 3 : 4)) ? 2 : 1;
+            double v = 0;
+            if ( ntok <= c || (!novalue && (ntok <= c+1 || !parsenumber (tok[c+1], &v))) ) {
+                printf ("ERROR: %s:%ld: bad bound\n", filename, lineno);
+                status = ERR_BADFILEFORMAT;
+                goto TERMINATE;
+            }
+            std::unordered_map<std::string,int>::iterator it = colind.find (tok[c]);
+            if ( it == colind.end () ) {
+                printf ("ERROR: %s:%ld: unknown column %s\n", filename, lineno, tok[c]);
+                status = ERR_BADFILEFORMAT;
+                goto TERMINATE;
+            }
+            int j = it->second;
+            if ( !strcmp (type, "UP") || !strcmp (type, "UI") ) {
+                prob->ub[j] = v;
+                /* the usual convention for a negative upper bound */
+                if ( v < 0 && prob->lb[j] == 0 ) prob->lb[j] = -HUGE_VAL;
+            } else if ( !strcmp (type, "LO") || !strcmp (type, "LI") ) {
+                prob->lb[j] = v;
+            } else if ( !strcmp (type, "FX") ) {
+                prob->lb[j] = v;
+                prob->ub[j] = v;
+            } else if ( !strcmp (type, "FR") ) {
+                prob->lb[j] = -HUGE_VAL;
+                prob->ub[j] = HUGE_VAL;
+            } else if ( !strcmp (type, "MI") ) {
+                prob->lb[j] = -HUGE_VAL;
+            } else if ( !strcmp (type, "PL") ) {
+                prob->ub[j] = HUGE_VAL;
+            } else if ( !strcmp (type, "BV") ) {
+                prob->lb[j] = 0;
+                prob->ub[j] = 1;
+            } else {
+                printf ("ERROR: %s:%ld: unsupported bound type %s\n", filename, lineno, type);
+                status = ERR_BADFILEFORMAT;
+                goto TERMINATE;
+            }
+            if ( type[1] == 'I' || type[0] == 'B' ) prob->ctype[j] = 'I';
+            break;
+        }
+        default:
+            printf ("ERROR: %s:%ld: data outside of a section\n", filename, lineno);
+            status = ERR_BADFILEFORMAT;
+            goto TERMINATE;
+        }
+    }
+    if ( sec != SEC_END ) {
+        printf ("ERROR: %s: missing ENDATA\n", filename);
+        status = ERR_BADFILEFORMAT;
+        goto TERMINATE;
+    }
+    prob->matbeg.push_back ((int)prob->matind.size ());
+
+    prob->rowlo.resize (prob->nrows);
+    prob->rowhi.resize (prob->nrows);
+    for(int i=0;i<prob->nrows;i++){
+        double r = fabs (rng[i]);
+        switch ( sense[i] ) {
+        case 'L':
+            prob->rowlo[i] = hasrng[i] ? rhs[i] - r : -HUGE_VAL;
+            prob->rowhi[i] = rhs[i];
+            break;
+        case 'G':
+            prob->rowlo[i] = rhs[i];
+            prob->rowhi[i] = hasrng[i] ? rhs[i] + r : HUGE_VAL;
+            break;
+        default:
+            prob->rowlo[i] = (hasrng[i] && rng[i] < 0) ? rhs[i] + rng[i] : rhs[i];
+            prob->rowhi[i] = (hasrng[i] && rng[i] > 0) ? rhs[i] + rng[i] : rhs[i];
+        }
+    }
+
+TERMINATE:
+
+    free (line);
+    if ( fin != NULL ) fclose (fin);
+
+    return status;
+}/*END readmps*/
@@ -0,0 +1,47 @@
+// Authors:	Sven Wiese
+//-----------------------------------------------------
+#ifndef mps_H
+#define mps_H
+
+#include <string>
+#include <vector>
+
+/* Mixed integer problem as read from an .mps file: min/max obj^T x
+ * subject to rowlo <= A x <= rowhi, lb <= x <= ub, with the columns
+ * marked 'I' integer. A is stored by column. Infinite bounds are
+ * +-HUGE_VAL. */
+struct mpsproblem {
+
+   mpsproblem() :	objsen(1),
+			objoffset(0),
+			nrows(0),
+			ncols(0){}
+
+   std::string name;
+   int objsen;        /* 1 minimize, -1 maximize */
+   double objoffset;  /* constant of the objective */
+   int nrows;
+   int ncols;
+   std::vector<double> obj;
+   std::vector<double> lb;
+   std::vector<double> ub;
+   std::vector<char> ctype;       /* 'C' or 'I' */
+   std::vector<double> rowlo;
+   std::vector<double> rowhi;
+   std::vector<int> matbeg;       /* [ncols+1] */
+   std::vector<int> matind;
+   std::vector<double> matval;
+   std::vector<std::string> colname;
+   std::vector<std::string> rowname;
+};
+
+/* Reads a fixed or free format .mps file: ROWS, COLUMNS with integer
+ * markers, RHS, RANGES, BOUNDS (UP, LO, FX, FR, MI, PL, BV, LI, UI)
+ * and OBJSENSE. Free rows other than the objective are dropped.
+ * Integer columns without bounds get [0,+inf). Errors are reported
+ * with the line number; returns ERR_BADFILEFORMAT on them. */
+int
+readmps (const char *filename,
+         mpsproblem *prob);
+
+#endif
@@ -0,0 +1,246 @@
+// Authors:	Sven Wiese
+//-----------------------------------------------------
+
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+#include "dualsimplex.hpp"
+#include "nativebb.hpp"
+#include "utils.hpp"
+
+/* bound of column j on the path from the root to a node */
+struct nodebound {
+   int j;
+   double lo;
+   double up;
+};
+
+struct nativenode {
+
+   nativenode() :	bound(-HUGE_VAL),
+			depth(0){}
+
+   double bound;      /* LP bound of the parent, minimization */
+   int depth;
+   std::vector<nodebound> bds;
+   std::shared_ptr< std::vector<signed char> > basis;   /* final basis of the parent */
+};
+
+/* orders the open nodes as a heap with the smallest bound on top */
+static bool
+worsebound (const nativenode *a,
+            const nativenode *b)
+{
+    return a->bound > b->bound;
+}/*END worsebound*/
+
+static double
+prunetol (double incumbent)
+{
+    return XMAX (1e-6, 1e-9*fabs (incumbent));
+}/*END prunetol*/
+
+int
+nativebranchandbound (const mpsproblem   *prob,
+                      const holeindex    *holes,
+                      const nativeparams *par,
+                      nativeresult       *res)
+{
+    typedef std::chrono::steady_clock clock;
+
+    int status = 0;
+    int n = prob->ncols;
+    int m = prob->nrows;
+    double sen = prob->objsen;
+    clock::time_point start = clock::now();
+    clock::time_point lastlog = start;
+    std::vector<double> obj(n);
+    std::vector<nativenode*> open;
+    std::vector<int> touched;
+    nativenode *next = new nativenode;
+    bool plunge = false;
+    double incumbent = HUGE_VAL;
+    dualsimplex ds;
+
+    *res = nativeresult();
+    /* the search minimizes, without the objective offset */
+    for(int j=0;j<n;j++) obj[j] = sen*prob->obj[j];
+    if ( fabs (par->cutoff) < 1e+75 ) incumbent = sen*(par->cutoff - prob->objoffset);
+    initdualsimplex (&ds, m, n, &obj[0], &prob->matbeg[0], &prob->matind[0], &prob->matval[0],
+                     &prob->lb[0], &prob->ub[0], &prob->rowlo[0], &prob->rowhi[0]);
+
+    for(;;){
+        if ( next == NULL ) {
+            if ( open.empty () ) break;
+            if ( par->depthfirst ) {
+                next = open.back ();
+                open.pop_back ();
+            } else {
+                std::pop_heap (open.begin (), open.end (), worsebound);
+                next = open.back ();
+                open.pop_back ();
+            }
+            plunge = false;
+        }
+        nativenode *node = next;
+        next = NULL;
+
+        if ( node->bound >= incumbent - prunetol (incumbent) ) {
+            delete node;
+            plunge = false;
+            continue;
+        }
+        double elapsed = std::chrono::duration<double>(clock::now () - start).count ();
+        if ( elapsed > par->timelimit || (par->nodelimit >= 0 && res->nodes >= par->nodelimit) ) {
+            res->status = elapsed > par->timelimit ? NATIVE_TIMELIMIT : NATIVE_NODELIMIT;
+            open.push_back (node);
+            break;
+        }
+
+        /* node LP: bounds of the path, warm start from the parent */
+        for(size_t k=0;k<touched.size();k++) setdualsimplexbounds (&ds, touched[k], prob->lb[touched[k]], prob->ub[touched[k]]);
+        touched.clear ();
+        for(size_t k=0;k<node->bds.size();k++){
+            setdualsimplexbounds (&ds, node->bds[k].j, node->bds[k].lo, node->bds[k].up);
+            touched.push_back (node->bds[k].j);
+        }
+        if ( !plunge && node->basis ) setdualsimplexbasis (&ds, *node->basis);
+        long iters = ds.iters;
+        int lpstat = solvedualsimplex (&ds, par->lpitlim);
+        res->lpiters += ds.iters - iters;
+        res->nodes++;
+        plunge = false;
+
+        if ( lpstat == LP_ITLIM ) {
+            printf ("ERROR: node LP not solved within %ld iterations\n", par->lpitlim);
+            status = ERR_BADLPSTAT;
+            delete node;
+            goto TERMINATE;
+        }
+        if ( lpstat == LP_NUMERIC ) {
+            printf ("ERROR: numerical trouble in the node LP at node %ld\n", res->nodes);
+            status = ERR_BADLPSTAT;
+            delete node;
+            goto TERMINATE;
+        }
+        if ( lpstat == LP_UNBOUNDED ) {
+            res->status = NATIVE_UNBOUNDED;
+            delete node;
+            break;
+        }
+        if ( lpstat == LP_INFEASIBLE || ds.objval >= incumbent - prunetol (incumbent) ) {
+            delete node;
+            continue;
+        }
+
+        const double *x = &ds.x[0];
+        double lpobj = ds.objval;
+        int bj = -1;
+        double pi0 = 0;
+        double pi1 = 0;
+
+        /* most fractional integer variable */
+        double maxfrac = EPSINT;
+        for(int j=0;j<n;j++){
+            if ( prob->ctype[j] != 'I' ) continue;
+            double f = x[j] - floor (x[j]);
+            if ( XMIN (f, 1-f) > maxfrac ) {
+                maxfrac = XMIN (f, 1-f);
+                bj = j;
+            }
+        }
+        if ( bj >= 0 ) {
+            int i = holes->ncols > bj ? holes->colvar[bj] : -1;
+            pi0 = floor (x[bj]);
+            pi1 = ceil (x[bj]);
+            if ( i >= 0 && widesplit (holes, i, x[bj], true, &pi0, &pi1) &&
+                 (pi0 != floor (x[bj]) || pi1 != ceil (x[bj])) ) res->snapped++;
+        } else {
+            /* integral: an incumbent unless it lies in a hole */
+            int var = -1;
+            res->candidates++;
+            int h = findviolation (holes, x, EPSVIOL, &var);
+            if ( h < 0 ) {
+                incumbent = lpobj;
+                res->hasincumbent = true;
+                res->x.assign (x, x + n);
+                for(int j=0;j<n;j++){
+                    if ( prob->ctype[j] == 'I' ) res->x[j] = floor (x[j] + 0.5);
+                }
+                if ( par->loglevel >= 1 ) {
+                    printf ("native: incumbent %.10f at node %ld, %.2lf sec\n", sen*incumbent + prob->objoffset,
+                            res->nodes, std::chrono::duration<double>(clock::now () - start).count ());
+                }
+                delete node;
+                continue;
+            }
+            res->rejected++;
+            res->holebranch++;
+            bj = holes->col[var];
+            widesplit (holes, var, x[bj], true, &pi0, &pi1);
+            if ( par->loglevel >= 2 ) printf ("native: %s = %g lies in a hole, branching on %g | %g\n",
+                                              holevarname (holes, var), x[bj], pi0, pi1);
+        }
+
+        /* children, moved out of the holes of bj */
+        {
+            int i = holes->ncols > bj ? holes->colvar[bj] : -1;
+            double lo[2] = {ds.lb[bj], pi1};
+            double up[2] = {pi0, ds.ub[bj]};
+            nativenode *child[2] = {NULL, NULL};
+            std::shared_ptr< std::vector<signed char> > basis = std::make_shared< std::vector<signed char> >(ds.stat);
+            for(int c=0;c<2;c++){
+                if ( i >= 0 && !snapholebounds (holes, i, &lo[c], &up[c]) ) continue;
+                if ( lo[c] > up[c] + EPSRHS ) continue;
+                nodebound b = {bj, lo[c], up[c]};
+                child[c] = new nativenode;
+                child[c]->bound = lpobj;
+                child[c]->depth = node->depth + 1;
+                child[c]->bds.reserve (node->bds.size () + 1);
+                child[c]->bds = node->bds;
+                child[c]->bds.push_back (b);
+                child[c]->basis = basis;
+            }
+            /* plunge into the child on the side x is closer to */
+            int first = (x[bj] - pi0 < pi1 - x[bj]) ? 0 : 1;
+            if ( child[first] == NULL ) first = 1 - first;
+            next = child[first];
+            plunge = next != NULL;
+            if ( child[1-first] != NULL ) {
+                open.push_back (child[1-first]);
+                if ( !par->depthfirst ) std::push_heap (open.begin (), open.end (), worsebound);
+            }
+            res->maxopen = XMAX (res->maxopen, (long)open.size ());
+        }
+
+        if ( par->loglevel >= 1 && std::chrono::duration<double>(clock::now () - lastlog).count () > 5 ) {
+            double bound = lpobj;
+            for(size_t k=0;k<open.size();k++) bound = XMIN (bound, open[k]->bound);
+            printf ("native: nodes %ld open %ld depth %d bound %.6f incumbent %.6f\n", res->nodes, (long)open.size (),
+                    node->depth, sen*bound + prob->objoffset,
+                    res->hasincumbent ? sen*incumbent + prob->objoffset : sen*HUGE_VAL);
+            lastlog = clock::now ();
+        }
+        delete node;
+    }
+
+    if ( res->status == 0 ) res->status = res->hasincumbent ? NATIVE_OPTIMAL : NATIVE_INFEASIBLE;
+    {
+        double bound = incumbent;
+        for(size_t k=0;k<open.size();k++) bound = XMIN (bound, open[k]->bound);
+        if ( res->status == NATIVE_UNBOUNDED ) bound = -HUGE_VAL;
+        res->bound = sen*bound + prob->objoffset;
+    }
+    res->objval = res->hasincumbent ? sen*incumbent + prob->objoffset : sen*HUGE_VAL;
+
+TERMINATE:
+
+    res->time = std::chrono::duration<double>(clock::now () - start).count ();
+    delete next;
+    for(size_t k=0;k<open.size();k++) delete open[k];
+
+    return status;
+}/*END nativebranchandbound*/
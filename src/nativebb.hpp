@@ -0,0 +1,86 @@
+// Authors:	Sven Wiese
+//-----------------------------------------------------
+#ifndef nativebb_H
+#define nativebb_H
+
+#include <vector>
+
+#include "holeindex.hpp"
+#include "mps.hpp"
+
+/* Final status of nativebranchandbound. */
+#define NATIVE_OPTIMAL     1
+#define NATIVE_INFEASIBLE  2
+#define NATIVE_UNBOUNDED   3
+#define NATIVE_TIMELIMIT   4
+#define NATIVE_NODELIMIT   5
+
+struct nativeparams {
+
+   nativeparams() :	timelimit(1e+75),
+			nodelimit(-1),
+			depthfirst(false),
+			lpitlim(100000),
+			cutoff(1e+75),
+			loglevel(1){}
+
+   double timelimit;  /* seconds */
+   long nodelimit;    /* -1: no limit */
+   bool depthfirst;   /* pure depth-first search, best-bound otherwise */
+   long lpitlim;      /* pivots per node LP */
+   double cutoff;     /* objective of a known solution, in the sense of the problem */
+   int loglevel;
+};
+
+/* Result of nativebranchandbound. bound and objval are in the sense of
+ * the problem and include its objective offset. The counters match
+ * the ones of the CPLEX callbacks: candidates are integral LP
+ * solutions, rejected ones lie in a hole; holebranch counts the
+ * branchings on a hole, snapped the fractional branchings whose
+ * children were moved out of holes. */
+struct nativeresult {
+
+   nativeresult() :	status(0),
+			nodes(0),
+			bound(0),
+			objval(0),
+			hasincumbent(false),
+			candidates(0),
+			rejected(0),
+			holebranch(0),
+			snapped(0),
+			lpiters(0),
+			maxopen(0),
+			time(0){}
+
+   int status;
+   long nodes;
+   double bound;
+   double objval;
+   bool hasincumbent;
+   int candidates;
+   int rejected;
+   int holebranch;
+   int snapped;
+   long lpiters;
+   long maxopen;
+   double time;
+   std::vector<double> x;
+};
+
+/* Solves prob, avoiding the holes of holes (which must be matched to
+ * the columns of prob), by LP based branch-and-bound: node LPs are
+ * reoptimized with the dual simplex from the basis of the parent, and
+ * the tree is searched depth-first, or best-bound first with plunging
+ * into a child of the last node. A variable in a hole is branched on
+ * by the wide split disjunction of the hole, a fractional integer
+ * variable by floor/ceil, and the child bounds are moved out of the
+ * holes they fall in. Returns 0 or an error code; the outcome of the
+ * search is res->status. */
+int
+nativebranchandbound (const mpsproblem   *prob,
+                      const holeindex    *holes,
+                      const nativeparams *par,
+                      nativeresult       *res);
+
+#endif
@@ -0,0 +1,170 @@
+// Authors:	Sven Wiese
+//-----------------------------------------------------
+
+#include "pseudocost.hpp"
+#include "utils.hpp"
+
+/* lower limit of a pseudo-cost estimate in the product score */
+#define PCMINGAIN  1E-06
+
+/* largest relative raise of the score of a variable with infeasible
+ * children, approached as their number grows */
+#define PCINFEASBONUS  1.0
+
+void
+initpseudocost (pseudocost *pc,
+                int        nvars)
+{
+    pc->downsum.assign(nvars, 0.0);
+    pc->upsum.assign(nvars, 0.0);
+    pc->ndown.assign(nvars, 0);
+    pc->nup.assign(nvars, 0);
+    pc->downtot = 0;
+    pc->uptot = 0;
+    pc->ndowntot = 0;
+    pc->nuptot = 0;
+    pc->downrate.reset(new std::atomic<double>[nvars > 0 ? nvars : 1]);
+    pc->uprate.reset(new std::atomic<double>[nvars > 0 ? nvars : 1]);
+    for(int i=0;i<nvars;i++){
+        pc->downrate[i].store(-1, std::memory_order_relaxed);
+        pc->uprate[i].store(-1, std::memory_order_relaxed);
+    }
+    pc->downavg = -1;
+    pc->upavg = -1;
+    pc->ninfeas.reset(new std::atomic<int>[nvars > 0 ? nvars : 1]);
+    for(int i=0;i<nvars;i++) pc->ninfeas[i].store(0, std::memory_order_relaxed);
+    pc->ninfeastot = 0;
+}/*END initpseudocost*/
+
+void
+updatepseudocost (pseudocost *pc,
+                  int        i,
+                  bool       up,
+                  double     dist,
+                  double     gain)
+{
+    if ( dist < EPSVIOL ) return;
+    double unit = XMAX (gain, 0.0)/dist;
+
+    std::lock_guard<std::mutex> guard(pc->lock);
+    if ( up ) {
+        pc->upsum[i] += unit;
+        pc->nup[i]++;
+        pc->uptot += unit;
+        pc->nuptot++;
+        pc->uprate[i].store(pc->upsum[i]/pc->nup[i], std::memory_order_relaxed);
+        pc->upavg.store(pc->uptot/pc->nuptot, std::memory_order_relaxed);
+    } else {
+        pc->downsum[i] += unit;
+        pc->ndown[i]++;
+        pc->downtot += unit;
+        pc->ndowntot++;
+        pc->downrate[i].store(pc->downsum[i]/pc->ndown[i], std::memory_order_relaxed);
+        pc->downavg.store(pc->downtot/pc->ndowntot, std::memory_order_relaxed);
+    }
+}/*END updatepseudocost*/
+
+void
+addpseudocostinfeas (pseudocost *pc,
+                     int        i)
+{
+    pc->ninfeas[i].fetch_add(1, std::memory_order_relaxed);
+    pc->ninfeastot.fetch_add(1, std::memory_order_relaxed);
+}/*END addpseudocostinfeas*/
+
+double
+pseudocostrate (pseudocost *pc,
+                int        i,
+                bool       up)
+{
+    double rate = (up ? pc->uprate[i] : pc->downrate[i]).load(std::memory_order_relaxed);
+    if ( rate >= 0 ) return rate;
+    double avg = (up ? pc->upavg : pc->downavg).load(std::memory_order_relaxed);
+    return avg >= 0 ? avg : 0.0;
+}/*END pseudocostrate*/
+
+int
+selectholevars (const holeindex *holes,
+                pseudocost      *pc,
+                const double    *x,
+                const double    *lb,
+                const double    *ub,
+                int             k,
+                int             *var,
+                int             *hole,
+                double          *score)
+{
+    int ncand = 0;
+    double *best = score;
+
+    double downavg = pc->downavg.load(std::memory_order_relaxed);
+    double upavg = pc->upavg.load(std::memory_order_relaxed);
+    if ( downavg < 0 ) downavg = 1.0;
+    if ( upavg < 0 ) upavg = 1.0;
+
+    for(int i=0;i<holes->nvars;i++){
+        int j = holes->col[i];
+        if ( j < 0 ) continue;
+        double v = x[j];
+        int h = findhole (holes, i, v, EPSVIOL);
+        if ( h < 0 ) continue;
+
+        double down = v - (holes->lb[h]-1);
+        double up = (holes->ub[h]+1) - v;
+        double pcdown = pc->downrate[i].load(std::memory_order_relaxed);
+        double pcup = pc->uprate[i].load(std::memory_order_relaxed);
+        if ( pcdown < 0 ) pcdown = downavg;
+        if ( pcup < 0 ) pcup = upavg;
+        double s = XMAX (pcdown*down, PCMINGAIN) * XMAX (pcup*up, PCMINGAIN);
+
+        /* prefer holes that leave narrow segments on both sides */
+        double width = ub[j] - lb[j] + 1;
+        if ( width < 1e+20 ) {
+            double removed = XMIN (holes->ub[h], ub[j]) - XMAX (holes->lb[h], lb[j]) + 1;
+            s *= 1 + XMAX (removed, 0.0)/width;
+        }
+        int nin = pc->ninfeas[i].load(std::memory_order_relaxed);
+        if ( nin > 0 ) s *= 1 + PCINFEASBONUS*nin/(nin + 1.0);
+
+        /* insert into the k best so far */
+        int pos = ncand;
+        while ( pos > 0 && best[pos-1] < s ) pos--;
+        if ( pos >= k ) continue;
+        if ( ncand < k ) ncand++;
+        for(int q=ncand-1;q>pos;q--){
+            best[q] = best[q-1];
+            var[q] = var[q-1];
+            hole[q] = hole[q-1];
+        }
+        best[pos] = s;
+        var[pos] = i;
+        hole[pos] = h;
+    }
+    return ncand;
+}/*END selectholevars*/
+
+void
+printpseudocost (FILE            *fout,
+                 const holeindex *holes,
+                 pseudocost      *pc,
+                 bool            verbose)
+{
+    std::lock_guard<std::mutex> guard(pc->lock);
+
+    int ninit = 0;
+    for(size_t i=0;i<pc->ndown.size();i++){
+        if ( pc->ndown[i] > 0 && pc->nup[i] > 0 ) ninit++;
+    }
+    fprintf (fout, "pseudo-costs: %d of %d variables initialized, updates down %ld up %ld, mean down %.4e up %.4e, infeasible children %ld\n",
+             ninit, (int)pc->ndown.size(), pc->ndowntot, pc->nuptot,
+             pc->ndowntot > 0 ? pc->downtot/pc->ndowntot : 0.0,
+             pc->nuptot > 0 ? pc->uptot/pc->nuptot : 0.0, pc->ninfeastot.load());
+    if ( !verbose ) return;
+    for(size_t i=0;i<pc->ndown.size();i++){
+        int nin = pc->ninfeas[i].load();
+        if ( pc->ndown[i] == 0 && pc->nup[i] == 0 && nin == 0 ) continue;
+        fprintf (fout, "  %-20s down %.4e (%d) up %.4e (%d) infeasible %d\n", holevarname (holes, (int)i),
+                 pc->ndown[i] > 0 ? pc->downsum[i]/pc->ndown[i] : 0.0, pc->ndown[i],
+                 pc->nup[i] > 0 ? pc->upsum[i]/pc->nup[i] : 0.0, pc->nup[i], nin);
+    }
+}/*END printpseudocost*/
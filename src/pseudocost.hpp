@@ -0,0 +1,102 @@
+// Authors:	Sven Wiese
+//-----------------------------------------------------
+#ifndef pseudocost_H
+#define pseudocost_H
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "holeindex.hpp"
+
+/* Pseudo-costs of the wide split branchings on the hole variables: the
+ * objective gain per unit of distance the LP value was moved, averaged
+ * separately over the down (x <= lb-1) and up (x >= ub+1) children.
+ * Variables without observations are scored with the average over all
+ * variables. Children found infeasible have no gain and are only
+ * counted per variable. All functions may be called from several threads; the
+ * updates are serialized by the lock, which also publishes the current
+ * rates as atomics, so the selection reads them without locking. */
+struct pseudocost {
+
+   pseudocost() :	downtot(0),
+			uptot(0),
+			ndowntot(0),
+			nuptot(0),
+			downavg(-1),
+			upavg(-1),
+			ninfeastot(0){}
+
+   std::vector<double> downsum;
+   std::vector<double> upsum;
+   std::vector<int> ndown;
+   std::vector<int> nup;
+   double downtot;
+   double uptot;
+   long ndowntot;
+   long nuptot;
+   std::unique_ptr< std::atomic<double>[] > downrate;   /* downsum/ndown, -1 without observations */
+   std::unique_ptr< std::atomic<double>[] > uprate;
+   std::atomic<double> downavg;   /* downtot/ndowntot, -1 without observations */
+   std::atomic<double> upavg;
+   std::unique_ptr< std::atomic<int>[] > ninfeas;   /* children found infeasible */
+   std::atomic<long> ninfeastot;
+   std::mutex lock;
+};
+
+void
+initpseudocost (pseudocost *pc,
+                int        nvars);
+
+/* Records the objective gain of a child of a branching on variable i,
+ * whose LP value was moved by dist down (up == false) or up. */
+void
+updatepseudocost (pseudocost *pc,
+                  int        i,
+                  bool       up,
+                  double     dist,
+                  double     gain);
+
+/* Records a child of a branching on variable i that was found
+ * infeasible. */
+void
+addpseudocostinfeas (pseudocost *pc,
+                     int        i);
+
+/* Expected objective gain per unit of distance of a down (up == false)
+ * or up branching on variable i. */
+double
+pseudocostrate (pseudocost *pc,
+                int        i,
+                bool       up);
+
+/* Ranks the hole variables to branch on at the LP solution x with local
+ * bounds lb/ub: among the variables whose value lies in a hole, the
+ * ones with the best product of down and up pseudo-cost estimates,
+ * weighted by the share of the local domain the hole removes and
+ * raised for variables with infeasible children. The best
+ * k variables are stored in var[], their holes in hole[], best first;
+ * score[] is scratch of size k. Returns their number, 0 if no value
+ * lies in a hole. Does not allocate or lock. */
+int
+selectholevars (const holeindex *holes,
+                pseudocost      *pc,
+                const double    *x,
+                const double    *lb,
+                const double    *ub,
+                int             k,
+                int             *var,
+                int             *hole,
+                double          *score);
+
+/* Writes a summary of the pseudo-costs to fout, and with verbose one
+ * line per variable with observations. */
+void
+printpseudocost (FILE            *fout,
+                 const holeindex *holes,
+                 pseudocost      *pc,
+                 bool            verbose);
+
+#endif
@@ -0,0 +1,120 @@
+// Authors:	Sven Wiese
+//-----------------------------------------------------
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "telemetry.hpp"
+#include "utils.hpp"
+
+void
+inittelemetry (telemetry         *tel,
+               const std::string &path,
+               double            interval,
+               const std::string &name)
+{
+    tel->path = path;
+    tel->interval = interval;
+    tel->labels = "instance=\"";
+    for(size_t k=0;k<name.size();k++){
+        if ( name[k] == '"' || name[k] == '\\' ) tel->labels += '\\';
+        tel->labels += name[k];
+    }
+    tel->labels += "\"";
+    tel->start = std::chrono::steady_clock::now ();
+    tel->last = tel->start;
+    tel->busy = false;
+    tel->writes = 0;
+    tel->failed = 0;
+}/*END inittelemetry*/
+
+bool
+telemetrydue (telemetry *tel)
+{
+    bool idle = false;
+
+    if ( tel->busy.load (std::memory_order_relaxed) ) return false;
+    if ( !tel->busy.compare_exchange_strong (idle, true, std::memory_order_acquire) ) return false;
+    if ( std::chrono::duration<double>(std::chrono::steady_clock::now () - tel->last).count () < tel->interval ) {
+        tel->busy.store (false, std::memory_order_release);
+        return false;
+    }
+    return true;
+}/*END telemetrydue*/
+
+double
+residentbytes ()
+{
+#ifdef __linux__
+    FILE *f = fopen ("/proc/self/statm", "r");
+    if ( f != NULL ) {
+        long size = 0;
+        long resident = 0;
+        int nread = fscanf (f, "%ld %ld", &size, &resident);
+        fclose (f);
+        if ( nread == 2 ) return (double) resident*sysconf (_SC_PAGESIZE);
+    }
+#endif
+    struct rusage ru;
+    if ( getrusage (RUSAGE_SELF, &ru) != 0 ) return 0;
+#ifdef __APPLE__
+    return (double) ru.ru_maxrss;
+#else
+    return 1024.0*ru.ru_maxrss;
+#endif
+}/*END residentbytes*/
+
+static void
+writemetric (FILE              *f,
+             const std::string &labels,
+             const char        *name,
+             const char        *label,
+             double            value)
+{
+    fprintf (f, "%s{%s%s%s} ", name, labels.c_str (), label != NULL ? "," : "", label != NULL ? label : "");
+    if ( std::isnan (value) ) fprintf (f, "NaN\n");
+    else if ( std::isinf (value) ) fprintf (f, "%s\n", value > 0 ? "+Inf" : "-Inf");
+    else fprintf (f, "%.10g\n", value);
+}/*END writemetric*/
+
+int
+writetelemetry (telemetry             *tel,
+                const telemetrymetric *m,
+                int                   n)
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now ();
+    std::string tmpname = tel->path + ".tmp";
+    int status = 0;
+
+    FILE *f = fopen (tmpname.c_str (), "w");
+    if ( f == NULL ) {
+        status = ERR_OPENFILE;
+        goto TERMINATE;
+    }
+    for(int k=0;k<n;k++){
+        if ( k == 0 || strcmp (m[k].name, m[k-1].name) != 0 ) {
+            fprintf (f, "# HELP %s %s\n", m[k].name, m[k].help);
+            fprintf (f, "# TYPE %s %s\n", m[k].name, m[k].type);
+        }
+        writemetric (f, tel->labels, m[k].name, m[k].label, m[k].value);
+    }
+    fprintf (f, "# HELP bah_elapsed_seconds Wall time since the start of the search.\n# TYPE bah_elapsed_seconds gauge\n");
+    writemetric (f, tel->labels, "bah_elapsed_seconds", NULL, std::chrono::duration<double>(now - tel->start).count ());
+    fprintf (f, "# HELP bah_resident_memory_bytes Resident memory of the process.\n# TYPE bah_resident_memory_bytes gauge\n");
+    writemetric (f, tel->labels, "bah_resident_memory_bytes", NULL, residentbytes ());
+    if ( ferror (f) ) status = ERR_OPENFILE;
+    if ( fclose (f) != 0 ) status = ERR_OPENFILE;
+    if ( !status && rename (tmpname.c_str (), tel->path.c_str ()) != 0 ) status = ERR_OPENFILE;
+
+TERMINATE:
+
+    if ( status ) tel->failed++;
+    else tel->writes++;
+    tel->last = now;
+    tel->busy.store (false, std::memory_order_release);
+    return status;
+}/*END writetelemetry*/
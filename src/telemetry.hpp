@@ -0,0 +1,67 @@
+// Authors:	Sven Wiese
+//-----------------------------------------------------
+#ifndef telemetry_H
+#define telemetry_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+/* One value of a snapshot. label is an optional Prometheus label set
+ * without braces, e.g. callback="branch"; metrics with several labels
+ * follow each other and share name, help and type. */
+struct telemetrymetric {
+   const char *name;
+   const char *help;
+   const char *type;  /* "gauge" or "counter" */
+   const char *label;
+   double value;
+};
+
+/* Periodic snapshot of the progress of a run in a text file, in the
+ * Prometheus exposition format. Each snapshot is written to path.tmp
+ * and renamed to path, so readers always see a complete file. */
+struct telemetry {
+
+   telemetry() :	interval(10),
+			busy(false),
+			writes(0),
+			failed(0){}
+
+   std::string path;
+   std::string labels;   /* labels of all metrics, e.g. instance="50v-10" */
+   double interval;      /* seconds between snapshots */
+   std::chrono::steady_clock::time_point start;
+   std::chrono::steady_clock::time_point last;
+   std::atomic<bool> busy;
+   long writes;
+   long failed;
+};
+
+/* Sets up the snapshots of path, every interval seconds, with the
+ * labels instance="name". */
+void
+inittelemetry (telemetry         *tel,
+               const std::string &path,
+               double            interval,
+               const std::string &name);
+
+/* True if a snapshot is due and no other thread is writing one; the
+ * caller must then call writetelemetry. */
+bool
+telemetrydue (telemetry *tel);
+
+/* Writes the n metrics m as the new snapshot, together with the
+ * elapsed time and the resident memory of the process. Returns 0 or
+ * ERR_OPENFILE. */
+int
+writetelemetry (telemetry             *tel,
+                const telemetrymetric *m,
+                int                   n);
+
+/* Resident memory of the process in bytes: the current one where the
+ * system reports it, the peak otherwise. */
+double
+residentbytes ();
+
+#endif
@@ -0,0 +1,554 @@
+// Authors:	Sven Wiese
+//-----------------------------------------------------
+// Unit tests of the hole engine (hole index, in-hole checks, bound
+// snapping, wide split disjunctions, hole presolve, variable selection)
+// of the native backend (.mps reader, dual simplex, branch-and-bound),
+// the callback latency histograms, the asynchronous log and the
+// telemetry snapshots, does not need CPLEX.
+//
+//   test_engine
+//
+// Prints one line per failed check and returns the number of failures.
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include "asynclog.hpp"
+#include "cbtiming.hpp"
+#include "dualsimplex.hpp"
+#include "holes.hpp"
+#include "holeindex.hpp"
+#include "mps.hpp"
+#include "nativebb.hpp"
+#include "pseudocost.hpp"
+#include "telemetry.hpp"
+#include "utils.hpp"
+
+static int nchecks = 0;
+static int nfailed = 0;
+
+#define CHECK(cond) do {                                                \
+      nchecks++;                                                        \
+      if ( !(cond) ) {                                                  \
+         nfailed++;                                                     \
+         printf ("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond);      \
+      }                                                                 \
+   } while (0)
+
+/* x0 in [0,100] with holes 10..20 and 40..50, x1 in [0,50] with the
+ * adjacent holes 5..5 and 6..9, and y with hole 1..2, which has no
+ * column. The columns are x0, x1, z. */
+static int
+buildtestindex (holeindex *idx)
+{
+    char n0[] = "x0", n1[] = "x1", n2[] = "y";
+    char *names[3] = {n0, n1, n2};
+    double lbvar[3] = {0, 0, 0};
+    double ubvar[3] = {100, 50, 10};
+    int nholes[3] = {2, 2, 1};
+    double l0[2] = {40, 10}, u0[2] = {50, 20};
+    double l1[2] = {5, 6}, u1[2] = {5, 9};
+    double l2[1] = {1}, u2[1] = {2};
+    double *lbholes[3] = {l0, l1, l2};
+    double *ubholes[3] = {u0, u1, u2};
+    char c0[] = "x0", c1[] = "x1", c2[] = "z";
+    char *colname[3] = {c0, c1, c2};
+    int nunmatched = 0;
+
+    int status = buildholeindex (3, lbvar, ubvar, nholes, names, lbholes, ubholes, idx);
+    if ( status ) return status;
+    status = matchholecols (idx, 3, colname, &nunmatched);
+    if ( status ) return status;
+    return nunmatched == 1 ? 0 : ERR_BADPROBLEM;
+}
+
+static void
+testnormalize ()
+{
+    double lb[4] = {30, 1, 35, 8};
+    double ub[4] = {40, 5, 50, 7};
+    int n = normalizeholes (lb, ub, 4);
+    CHECK (n == 2);
+    CHECK (lb[0] == 1 && ub[0] == 5);
+    CHECK (lb[1] == 30 && ub[1] == 50);
+}
+
+static void
+testfind (const holeindex *idx)
+{
+    CHECK (idx->nvars == 3 && idx->nholes == 5);
+    CHECK (idx->beg[1] == 2);
+    CHECK (idx->lb[0] == 10 && idx->ub[0] == 20);
+    CHECK (idx->col[0] == 0 && idx->col[1] == 1 && idx->col[2] == -1);
+    CHECK (idx->colvar[2] == -1);
+
+    CHECK (findhole (idx, 0, 15, 0.0) == 0);
+    CHECK (findhole (idx, 0, 9.5, 0.0) == 0);
+    CHECK (findhole (idx, 0, 20.5, 0.0) == 0);
+    CHECK (findhole (idx, 0, 9, 0.0) == -1);
+    CHECK (findhole (idx, 0, 21, 0.0) == -1);
+    CHECK (findhole (idx, 0, 9.5, 0.6) == -1);
+    CHECK (findhole (idx, 0, 45, 0.0) == 1);
+    CHECK (findhole (idx, 0, 75, 0.0) == -1);
+    CHECK (findholecol (idx, 1, 8, 0.0) == 3);
+    CHECK (findholecol (idx, 2, 1.5, 0.0) == -1);
+}
+
+static void
+testviolation (const holeindex *idx)
+{
+    double x0[3] = {9, 10, 1.5};
+    double x1[3] = {45, 0, 0};
+    double x2[3] = {0, 5.5, 0};
+    int var = -1;
+
+    /* z has no holes, the hole of y has no column */
+    CHECK (findviolation (idx, x0, EPSVIOL, &var) == -1);
+    CHECK (findviolation (idx, x1, EPSVIOL, &var) == 1 && var == 0);
+    CHECK (findviolation (idx, x2, EPSVIOL, &var) >= 2 && var == 1);
+}
+
+static void
+testsnap (const holeindex *idx)
+{
+    double lo = 12, up = 45;
+    CHECK (snapholebounds (idx, 0, &lo, &up));
+    CHECK (lo == 21 && up == 39);
+
+    lo = 0;
+    up = 100;
+    CHECK (snapholebounds (idx, 0, &lo, &up));
+    CHECK (lo == 0 && up == 100);
+
+    /* adjacent holes are passed in one go */
+    lo = 5;
+    up = 50;
+    CHECK (snapholebounds (idx, 1, &lo, &up));
+    CHECK (lo == 10);
+
+    lo = 12;
+    up = 18;
+    CHECK (!snapholebounds (idx, 0, &lo, &up));
+}
+
+static void
+testwidesplit (const holeindex *idx)
+{
+    double pi0 = 0, pi1 = 0;
+    CHECK (widesplit (idx, 0, 15.5, true, &pi0, &pi1));
+    CHECK (pi0 == 9 && pi1 == 21);
+    CHECK (widesplit (idx, 0, 30.5, true, &pi0, &pi1));
+    CHECK (pi0 == 30 && pi1 == 31);
+    CHECK (!widesplit (idx, 0, 30, true, &pi0, &pi1));
+    CHECK (!widesplit (idx, 0, 30.5, false, &pi0, &pi1));
+    /* the up side runs into the next hole */
+    CHECK (widesplit (idx, 1, 4.5, true, &pi0, &pi1));
+    CHECK (pi0 == 4 && pi1 == 10);
+}
+
+static void
+testsegments (const holeindex *idx)
+{
+    double segl[4], segu[4];
+    int n = holesegments (idx, 0, 0, 100, -HUGE_VAL, 4, segl, segu);
+    CHECK (n == 3);
+    CHECK (segl[0] == 0 && segu[0] == 9);
+    CHECK (segl[1] == 21 && segu[1] == 39);
+    CHECK (segl[2] == 51 && segu[2] == 100);
+
+    n = holesegments (idx, 0, 0, 100, -HUGE_VAL, 2, segl, segu);
+    CHECK (n == 2);
+    CHECK (segl[0] == 0 && segu[1] == 100);
+
+    /* v in the hole 40..50 is a part boundary: [0,39] | [51,100] */
+    n = holesegments (idx, 0, 0, 100, 45, 2, segl, segu);
+    CHECK (n == 2);
+    CHECK (segl[0] == 0 && segu[0] == 39 && segl[1] == 51 && segu[1] == 100);
+    /* ... also with a single part allowed */
+    n = holesegments (idx, 0, 0, 100, 15, 1, segl, segu);
+    CHECK (n == 2);
+    CHECK (segl[0] == 0 && segu[0] == 9 && segl[1] == 21 && segu[1] == 100);
+
+    n = holesegments (idx, 0, 25, 35, -HUGE_VAL, 4, segl, segu);
+    CHECK (n == 1 && segl[0] == 25 && segu[0] == 35);
+
+    CHECK (holesegments (idx, 0, 12, 18, 15, 4, segl, segu) == 0);
+}
+
+static void
+testreduce ()
+{
+    holeindex idx;
+    holereduction red;
+    CHECK (buildtestindex (&idx) == 0);
+
+    /* x1 starts in its second hole, the hole file bounds x0 tighter
+     * than the model but must not tighten it */
+    double lb[3] = {0, 7, 0};
+    double ub[3] = {200, 50, 1};
+    CHECK (reduceholes (&idx, lb, ub, &red) == 0);
+    CHECK (red.bounddiff == 2 && ub[0] == 200 && idx.ubvar[0] == 200);
+    CHECK (red.merged == 1);
+    CHECK (red.tightened == 1 && lb[1] == 10);
+    CHECK (red.clipped == 1);
+    CHECK (red.dropped == 1);
+    CHECK (red.infeasible == 0);
+    CHECK (idx.nvars == 2 && idx.nholes == 3);
+    CHECK (idx.col[0] == 0 && idx.colvar[1] == -1);
+    CHECK (findholecol (&idx, 0, 45, 0.0) == 1);
+
+    double x[3] = {0, 7, 0};
+    int var = -1;
+    CHECK (findviolation (&idx, x, EPSVIOL, &var) == -1);
+
+    freeholeindex (&idx);
+}
+
+static void
+testselect (const holeindex *idx)
+{
+    pseudocost pc;
+    initpseudocost (&pc, idx->nvars);
+
+    CHECK (pseudocostrate (&pc, 0, false) == 0);
+    updatepseudocost (&pc, 0, false, 2.0, 4.0);
+    CHECK (pseudocostrate (&pc, 0, false) == 2.0);
+    /* no observations for x1, the average over all variables is used */
+    CHECK (pseudocostrate (&pc, 1, false) == 2.0);
+    CHECK (pseudocostrate (&pc, 1, true) == 0);
+    /* a negative gain counts as none */
+    updatepseudocost (&pc, 1, true, 1.0, -3.0);
+    CHECK (pseudocostrate (&pc, 1, true) == 0);
+
+    double x[3] = {15, 8, 0};
+    double lb[3] = {0, 0, 0};
+    double ub[3] = {100, 50, 10};
+    int var[2], hole[2];
+    double score[2];
+    int n = selectholevars (idx, &pc, x, lb, ub, 2, var, hole, score);
+    CHECK (n == 2);
+    CHECK (var[0] != var[1]);
+    for(int k=0;k<n;k++) CHECK (findhole (idx, var[k], x[idx->col[var[k]]], EPSVIOL) == hole[k]);
+
+    /* an infeasible child raises the score, not the rates */
+    int v1 = var[1];
+    double s1 = score[1];
+    double rate = pseudocostrate (&pc, v1, false);
+    addpseudocostinfeas (&pc, v1);
+    CHECK (pseudocostrate (&pc, v1, false) == rate);
+    CHECK (selectholevars (idx, &pc, x, lb, ub, 2, var, hole, score) == 2);
+    for(int k=0;k<2;k++) if ( var[k] == v1 ) CHECK (fabs (score[k] - 1.5*s1) < 1e-9*s1);
+
+    x[0] = 30;
+    x[1] = 2;
+    CHECK (selectholevars (idx, &pc, x, lb, ub, 2, var, hole, score) == 0);
+}
+
+static void
+testbinary (const holeindex *idx)
+{
+    char binname[] = "/tmp/test_engineXXXXXX";
+    int fd = mkstemp (binname);
+    CHECK (fd >= 0);
+    if ( fd < 0 ) return;
+    close (fd);
+
+    /* a text file the index was read from */
+    char srcname[] = "/tmp/test_engineXXXXXX";
+    fd = mkstemp (srcname);
+    CHECK (fd >= 0);
+    if ( fd < 0 ) return;
+    CHECK (write (fd, "x0 0 100 1 10 20\n", 17) == 17);
+    close (fd);
+
+    holeindex copy;
+    CHECK (writeholes_bin (binname, idx, srcname) == 0);
+    CHECK (holebinmatches (binname, srcname));
+    CHECK (holebinmatches (binname, "/nonexistent/holes.txt"));
+    FILE *f = fopen (srcname, "a");
+    if ( f != NULL ) {
+        fputs ("x1 0 50 1 5 5\n", f);
+        fclose (f);
+    }
+    CHECK (!holebinmatches (binname, srcname));
+    unlink (srcname);
+    CHECK (readholes_bin (binname, &copy) == 0);
+    CHECK (copy.nvars == idx->nvars && copy.nholes == idx->nholes);
+    for(int h=0;h<idx->nholes && h<copy.nholes;h++)
+        CHECK (copy.lb[h] == idx->lb[h] && copy.ub[h] == idx->ub[h]);
+    CHECK (strcmp (holevarname (&copy, 2), "y") == 0);
+    freeholeindex (&copy);
+    unlink (binname);
+}
+
+/* max 5x + 4y + 3z  s.t.  2x + 3y + z <= 5,  4x + y + 2z <= 11,
+ * 3x + 4y + 2z <= 8,  x, y, z >= 0 integer, y <= 3, with the LP
+ * optimum 13 at (2,0,1) */
+static const char *testmps =
+    "NAME          TESTLP\n"
+    "OBJSENSE\n"
+    "    MAX\n"
+    "ROWS\n"
+    " N  obj\n"
+    " L  c1\n"
+    " L  c2\n"
+    " L  c3\n"
+    "COLUMNS\n"
+    "    MARKER                 'MARKER'                 'INTORG'\n"
+    "    x         obj       5.0          c1        2.0\n"
+    "    x         c2        4.0          c3        3.0\n"
+    "    y         obj       4.0          c1        3.0\n"
+    "    y         c2        1.0          c3        4.0\n"
+    "    z         obj       3.0          c1        1.0\n"
+    "    z         c2        2.0          c3        2.0\n"
+    "    MARKER                 'MARKER'                 'INTEND'\n"
+    "RHS\n"
+    "    rhs       c1        5.0          c2        11.0\n"
+    "    rhs       c3        8.0\n"
+    "BOUNDS\n"
+    " UP bnd       y         3.0\n"
+    "ENDATA\n";
+
+static void
+testnative ()
+{
+    char mpsname[] = "/tmp/test_engineXXXXXX";
+    int fd = mkstemp (mpsname);
+    CHECK (fd >= 0);
+    if ( fd < 0 ) return;
+    CHECK (write (fd, testmps, strlen (testmps)) == (ssize_t)strlen (testmps));
+    close (fd);
+
+    mpsproblem prob;
+    CHECK (readmps (mpsname, &prob) == 0);
+    unlink (mpsname);
+    CHECK (prob.nrows == 3 && prob.ncols == 3 && prob.objsen == -1);
+    if ( prob.nrows != 3 || prob.ncols != 3 ) return;
+    CHECK (prob.ctype[0] == 'I' && prob.ub[1] == 3 && std::isinf (prob.ub[0]));
+    CHECK (prob.matbeg[3] == 9 && std::isinf (prob.rowlo[0]) && prob.rowhi[1] == 11);
+
+    /* LP relaxation, minimizing the negated objective */
+    dualsimplex ds;
+    double obj[3] = {-5, -4, -3};
+    initdualsimplex (&ds, 3, 3, obj, &prob.matbeg[0], &prob.matind[0], &prob.matval[0],
+                     &prob.lb[0], &prob.ub[0], &prob.rowlo[0], &prob.rowhi[0]);
+    CHECK (solvedualsimplex (&ds, 1000) == LP_OPTIMAL);
+    CHECK (fabs (ds.objval + 13) < 1e-9);
+    CHECK (fabs (ds.x[0] - 2) < 1e-9 && fabs (ds.x[2] - 1) < 1e-9);
+    /* reoptimize after a bound change: x <= 1 gives 12.5 at (1,0,2.5) */
+    setdualsimplexbounds (&ds, 0, 0, 1);
+    CHECK (solvedualsimplex (&ds, 1000) == LP_OPTIMAL);
+    CHECK (fabs (ds.objval + 12.5) < 1e-9);
+    setdualsimplexbounds (&ds, 0, 3, HUGE_VAL);
+    CHECK (solvedualsimplex (&ds, 1000) == LP_INFEASIBLE);
+
+    /* min y s.t. y <= -2e7, y <= 0: the row is out of reach only from
+     * the artificial bound of y, which is no proof of infeasibility */
+    dualsimplex dsart;
+    double objart[1] = {1};
+    int begart[2] = {0, 1}, indart[1] = {0};
+    double valart[1] = {1};
+    double lbart[1] = {-HUGE_VAL}, ubart[1] = {0};
+    double rlart[1] = {-HUGE_VAL}, rhart[1] = {-2e+07};
+    initdualsimplex (&dsart, 1, 1, objart, begart, indart, valart, lbart, ubart, rlart, rhart);
+    CHECK (solvedualsimplex (&dsart, 1000) == LP_NUMERIC);
+
+    /* min y s.t. y >= -2e7, y free: bounded, the artificial bound of
+     * the slack is moved out; without the row the LP is unbounded */
+    rlart[0] = -2e+07;
+    rhart[0] = HUGE_VAL;
+    ubart[0] = HUGE_VAL;
+    initdualsimplex (&dsart, 1, 1, objart, begart, indart, valart, lbart, ubart, rlart, rhart);
+    CHECK (solvedualsimplex (&dsart, 1000) == LP_OPTIMAL);
+    CHECK (fabs (dsart.objval + 2e+07) < 1e-6);
+    rlart[0] = -HUGE_VAL;
+    initdualsimplex (&dsart, 1, 1, objart, begart, indart, valart, lbart, ubart, rlart, rhart);
+    CHECK (solvedualsimplex (&dsart, 1000) == LP_UNBOUNDED);
+
+    /* x has the hole 2..2: the MIP optimum is found by enumeration */
+    char nx[] = "x";
+    char *names[1] = {nx};
+    double lbvar[1] = {0}, ubvar[1] = {10};
+    int nholes[1] = {1};
+    double lh[1] = {2}, uh[1] = {2};
+    double *lbholes[1] = {lh};
+    double *ubholes[1] = {uh};
+    char cx[] = "x", cy[] = "y", cz[] = "z";
+    char *colname[3] = {cx, cy, cz};
+    int nunmatched = 0;
+    holeindex holes;
+    CHECK (buildholeindex (1, lbvar, ubvar, nholes, names, lbholes, ubholes, &holes) == 0);
+    CHECK (matchholecols (&holes, 3, colname, &nunmatched) == 0 && nunmatched == 0);
+
+    double best = -HUGE_VAL;
+    for(int x=0;x<=5;x++){
+        for(int y=0;y<=3;y++){
+            for(int z=0;z<=8;z++){
+                if ( x == 2 || 2*x+3*y+z > 5 || 4*x+y+2*z > 11 || 3*x+4*y+2*z > 8 ) continue;
+                best = XMAX (best, 5.0*x + 4*y + 3*z);
+            }
+        }
+    }
+
+    for(int dfs=0;dfs<2;dfs++){
+        nativeparams par;
+        nativeresult res;
+        par.depthfirst = dfs == 1;
+        par.loglevel = 0;
+        CHECK (nativebranchandbound (&prob, &holes, &par, &res) == 0);
+        CHECK (res.status == NATIVE_OPTIMAL);
+        CHECK (fabs (res.objval - best) < 1e-6 && fabs (res.bound - best) < 1e-6);
+        CHECK (res.hasincumbent && res.x[0] != 2);
+    }
+    freeholeindex (&holes);
+}
+
+static void
+testlatency ()
+{
+    cblatency a, b, none;
+    for(int k=0;k<90;k++) addlatency (&a, 100);    /* bucket [64,128) */
+    for(int k=0;k<9;k++) addlatency (&b, 5000);    /* bucket [4096,8192) */
+    addlatency (&b, 1000000);
+    addlatency (&b, 0);
+
+    mergelatency (&a, &b);
+    CHECK (a.calls == 101);
+    CHECK (a.totalns == 90*100 + 9*5000 + 1000000);
+    CHECK (a.maxns == 1000000);
+    CHECK (a.bucket[0] == 1 && a.bucket[6] == 90 && a.bucket[12] == 9 && a.bucket[19] == 1);
+    CHECK (latencyquantile (&a, 0.5) == 128);
+    CHECK (latencyquantile (&a, 0.95) == 8192);
+    CHECK (latencyquantile (&a, 1.0) == 1000000);
+    CHECK (latencyquantile (&b, 0.0) == 2);
+    CHECK (latencyquantile (&none, 0.5) == 0);
+}
+
+static void
+testasynclog ()
+{
+    char buf[256];
+    logring ring;
+    ring.rec.resize (2);
+    ring.mask = 1;
+
+    logmsg (&ring, LOG_SCREEN, "%s = %.2lf in hole %d of %ld, %c %5.1f%% %x\n", "x1", 7.5, 3, 12L, 'L', 99.25, 255u);
+    formatlogrecord (buf, sizeof (buf), &ring.rec[0]);
+    CHECK (strcmp (buf, "x1 = 7.50 in hole 3 of 12, L  99.2% ff\n") == 0);
+    logmsg (&ring, LOG_FILE, "missing %d %s\n", -4);
+    formatlogrecord (buf, sizeof (buf), &ring.rec[1]);
+    CHECK (strcmp (buf, "missing -4 %s\n") == 0);
+    formatlogrecord (buf, 8, &ring.rec[0]);
+    CHECK (strcmp (buf, "x1 = 7.") == 0);
+    /* the ring is full: dropped, not overwritten */
+    logmsg (&ring, LOG_SCREEN, "dropped\n");
+    CHECK (ring.dropped == 1 && ring.head == 2);
+
+    /* all records of all threads reach the file, in time order */
+    char logname[] = "/tmp/test_engineXXXXXX";
+    int fd = mkstemp (logname);
+    CHECK (fd >= 0);
+    if ( fd < 0 ) return;
+    close (fd);
+    FILE *fout = fopen (logname, "w");
+    asynclog log;
+    CHECK (startasynclog (&log, 2, 1000, fout) == 0);
+    std::thread other ([&log](){ for(int k=0;k<500;k++) logmsg (&log.rings[1], LOG_FILE, "b %d\n", k); });
+    for(int k=0;k<500;k++) logmsg (&log.rings[0], LOG_FILE, "a %d\n", k);
+    other.join ();
+    stopasynclog (&log);
+    fclose (fout);
+    CHECK (log.written == 1000 && log.dropped == 0);
+    fout = fopen (logname, "r");
+    int na = 0, nb = 0, k = 0;
+    bool ordered = true;
+    while ( fout != NULL && fscanf (fout, "%255s %d", buf, &k) == 2 ) {
+        int *next = buf[0] == 'a' ? &na : &nb;
+        if ( k != *next ) ordered = false;
+        (*next)++;
+    }
+    CHECK (na == 500 && nb == 500 && ordered);
+    if ( fout != NULL ) fclose (fout);
+    unlink (logname);
+}
+
+static void
+testtelemetry ()
+{
+    char dir[] = "/tmp/test_engineXXXXXX";
+    CHECK (mkdtemp (dir) != NULL);
+    std::string path = std::string(dir) + "/run.prom";
+    telemetry tel;
+    inittelemetry (&tel, path, 3600, "in\"st");
+
+    /* not due before the interval has passed, due once it has */
+    CHECK (!telemetrydue (&tel));
+    tel.interval = 0;
+    CHECK (telemetrydue (&tel));
+    CHECK (!telemetrydue (&tel));   /* another thread is writing */
+    telemetrymetric m[] = {
+        {"bah_nodes", "Nodes.", "counter", NULL, 42},
+        {"bah_gap", "Gap.", "gauge", NULL, NAN},
+        {"bah_time", "Time.", "counter", "callback=\"cut\"", 1.5},
+        {"bah_time", "Time.", "counter", "callback=\"branch\"", -HUGE_VAL},
+    };
+    CHECK (writetelemetry (&tel, m, 4) == 0);
+    CHECK (tel.writes == 1 && tel.failed == 0);
+    CHECK (access ((path + ".tmp").c_str (), F_OK) != 0);
+
+    std::string text;
+    char line[256];
+    FILE *f = fopen (path.c_str (), "r");
+    CHECK (f != NULL);
+    while ( f != NULL && fgets (line, sizeof (line), f) != NULL ) text += line;
+    if ( f != NULL ) fclose (f);
+    CHECK (text.find ("# TYPE bah_nodes counter\nbah_nodes{instance=\"in\\\"st\"} 42\n") != std::string::npos);
+    CHECK (text.find ("bah_gap{instance=\"in\\\"st\"} NaN\n") != std::string::npos);
+    CHECK (text.find ("# HELP bah_time") == text.rfind ("# HELP bah_time"));
+    CHECK (text.find ("bah_time{instance=\"in\\\"st\",callback=\"branch\"} -Inf\n") != std::string::npos);
+    CHECK (text.find ("bah_resident_memory_bytes{") != std::string::npos);
+    CHECK (residentbytes () > 0);
+
+    /* a directory that does not exist */
+    tel.path = path + "/missing/run.prom";
+    CHECK (telemetrydue (&tel));
+    CHECK (writetelemetry (&tel, m, 4) == ERR_OPENFILE && tel.failed == 1);
+    unlink (path.c_str ());
+    rmdir (dir);
+}
+
+int main()
+{
+    holeindex idx;
+
+    int status = buildtestindex (&idx);
+    if ( status ) {
+        printf ("ERROR: cannot build the test index (%d)\n", status);
+        return 1;
+    }
+
+    testnormalize ();
+    testfind (&idx);
+    testviolation (&idx);
+    testsnap (&idx);
+    testwidesplit (&idx);
+    testsegments (&idx);
+    testreduce ();
+    testselect (&idx);
+    testbinary (&idx);
+    testnative ();
+    testlatency ();
+    testasynclog ();
+    testtelemetry ();
+
+    freeholeindex (&idx);
+
+    printf ("%d checks, %d failed\n", nchecks, nfailed);
+    return nfailed;
+}